@@ -11,6 +11,14 @@
     #include <dmnode.h>
     #include <dmview.h>
     #include <cgalgeometry.h>
+    #include <preparedface.h>
+    #include <straightskeleton.h>
+    #include <indexedmesh.h>
+    #include <triangulationcache.h>
+    #include <meshsizefield.h>
+    #include <meshtopology.h>
+    #include <triangulaterasterdata.h>
+    #include <spatialsearchnearestnodes.h>
     using namespace std;
     using namespace DM;
 %}
@@ -25,11 +33,21 @@
 %include "../../DynaMind/src/core/dmedge.h"
 %include "../../DynaMind/src/core/dmnode.h"
 %include "../../DynaMind/src/core/dmview.h"
+%include "../src/meshsizefield.h"
 %include "../src/cgalgeometry.h"
+%include "../src/preparedface.h"
+%include "../src/straightskeleton.h"
+%include "../src/indexedmesh.h"
+%include "../src/meshtopology.h"
+%include "../src/triangulaterasterdata.h"
+%include "../src/spatialsearchnearestnodes.h"
+%include "../src/triangulationcache.h"
 
 namespace std {
     %template(stringvector) vector<string>;
     %template(doublevector) vector<double>;
+    %template(intvector) vector<int>;
+    %template(uintvector) vector<unsigned int>;
     %template(systemvector) vector<DM::System* >;
     %template(systemmap) map<string, DM::System* >;
     %template(edgevector) vector<DM::Edge* >;
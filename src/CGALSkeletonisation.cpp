@@ -37,111 +37,103 @@
 #include <dmgeometry.h>
 #include <print_utils.h>
 
-#include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
-#include <CGAL/Polygon_2.h>
-#include <CGAL/Point_2.h>
-#include <CGAL/create_offset_polygons_2.h>
-#include <cgalgeometry.h>
+#include <algorithm>
+#include <set>
+#include <straightskeletoncache.h>
+#include <geometrylogger.h>
+
+namespace {
+typedef DM::StraightSkeletonCache::Ss    Ss;
+typedef Ss::Vertex_const_handle          Vertex_const_handle;
+typedef Ss::Halfedge_const_handle        Halfedge_const_handle;
+typedef Ss::Face_const_iterator          Face_const_iterator;
+typedef DM::StraightSkeletonCache::SsPtr SsPtr;
+}
 
 namespace DM {
 
-DM::System CGALSkeletonisation::StraightSkeletonisation(System *sys, Face *f, double alpha)
+bool CGALSkeletonisation::RoofFaces(const std::vector<double> &xy, double z0, double alpha, std::vector<double> &xyz, std::vector<unsigned int> &faceOffsets)
 {
-	DM::System sys_tmp;
-
-	typedef CGAL::Exact_predicates_inexact_constructions_kernel K ;
-
-	typedef K::Point_2                   Point_2 ;
-	typedef CGAL::Polygon_2<K>           Polygon_2 ;
-	typedef CGAL::Straight_skeleton_2<K> Ss ;
+	xyz.clear();
+	faceOffsets.assign(1, 0);
+
+	//Skeletons of unchanged footprints are reused from the cache
+	SsPtr iss = StraightSkeletonCache::InteriorStraightSkeleton(xy);
+	if(!iss)
+		return false;
+
+	//Every skeleton face belongs to one contour edge, the time of a vertex is its distance to the contour
+	double slope = tan(alpha / 180. * M_PI);
+	const Ss & ss = *iss;
+	for (Face_const_iterator fi = ss.faces_begin(); fi != ss.faces_end(); ++fi) {
+		Halfedge_const_handle start = fi->halfedge();
+		Halfedge_const_handle h = start;
+		do {
+			Vertex_const_handle v = h->vertex();
+			xyz.push_back(v->point().x());
+			xyz.push_back(v->point().y());
+			xyz.push_back(z0 + v->time() * slope);
+			h = h->next();
+		} while (h != start);
+		faceOffsets.push_back(xyz.size() / 3);
+	}
+	return true;
+}
 
-	typedef  Ss::Vertex_const_handle     Vertex_const_handle ;
-	typedef  Ss::Halfedge_const_handle   Halfedge_const_handle ;
-	typedef  Ss::Halfedge_const_iterator Halfedge_const_iterator ;
-	typedef  Ss::Face_const_handle        Face_const_handle;
-	typedef  Ss::Face_const_iterator      Face_const_iterator;
-	typedef  boost::shared_ptr<Ss> SsPtr ;
-	typedef K::FT                        FT ;
-	typedef boost::shared_ptr<Polygon_2> PolygonPtr ;
-	typedef std::vector<PolygonPtr> PolygonPtrVector ;
+std::vector<std::vector<Node> > CGALSkeletonisation::RoofFaces(const std::vector<double> &xy, double z0, double alpha)
+{
+	std::vector<std::vector<DM::Node> > roofs;
+	std::vector<double> xyz;
+	std::vector<unsigned int> faceOffsets;
+	if (!RoofFaces(xy, z0, alpha, xyz, faceOffsets)) {
+		Logger(Warning) << "Can't perform offset polygon is not simple";
+		return roofs;
+	}
 
+	for (unsigned int i = 0; i + 1 < faceOffsets.size(); i++) {
+		std::vector<DM::Node> roof;
+		for (unsigned int j = faceOffsets[i]; j < faceOffsets[i+1]; j++)
+			roof.push_back(DM::Node(xyz[3*j], xyz[3*j+1], xyz[3*j+2]));
+		roofs.push_back(roof);
+	}
+	return roofs;
+}
 
+DM::System CGALSkeletonisation::StraightSkeletonisation(System *sys, Face *f, double alpha)
+{
+	DM::System sys_tmp;
 	DM::SpatialNodeHashMap sphn(&sys_tmp, 10.);
 
-	std::vector<DM::Node> ressVector;
 	DM::View view_roof_lines("Roof_Edges", DM::EDGE, DM::WRITE);
 	DM::View view_roof_faces("Roof", DM::FACE, DM::WRITE);
-	Polygon_2 poly_s;
-
 
+	std::vector<double> xy;
+	double z0 = 0;
 	foreach(DM::Node * p, f->getNodePointers()) {
-		poly_s.push_back(Point_2(p->getX(), p->getY()));
-		sphn.addNode(p->getX(), p->getY(), p->getZ(),0.0001, DM::View());
-	}
-
-	if(!poly_s.is_simple()) {
-		Logger(Warning) << "Can't perform offset polygon is not simple";
-		return sys_tmp;
-	}
-
-	CGAL::Orientation orient = poly_s.orientation();
-	if (orient == CGAL::CLOCKWISE) {
-		poly_s.reverse_orientation();
+		xy.push_back(p->getX());
+		xy.push_back(p->getY());
+		z0 = p->getZ();
 	}
 
-	// You can pass the polygon via an iterator pair
-	SsPtr iss = CGAL::create_interior_straight_skeleton_2(poly_s.vertices_begin(), poly_s.vertices_end());
-//	std::vector<DM::Node*> new_nodes;
-	for ( Halfedge_const_iterator i = iss->halfedges_begin(); i !=  iss->halfedges_end(); ++i )
-	{
-		Point_2 p = i->opposite()->vertex()->point();
-
-		Logger(Debug) << "(" << p.x() << "," << p.y() << ")" ;
-		Logger(Debug) << "->" ;
-		Point_2 p1 = i->vertex()->point();
-		Logger(Debug) << "(" << p1.x() << "," << p1.y() << ")" ;
-		Logger(Debug) << " " << ( i->is_bisector() ? "bisector" : "contour" );
-		double dx = p1.x() -  p.x();
-		double dy = p1.y() -  p.y();
-		double l = sqrt(dx * dx + dy * dy);
-		double h = l*cos(30./180.*M_PI);
-		ressVector.push_back(DM::Node(p.x(), p.y(),0));
-
-//		if (!sphn.findNode(p.x(), p.y(), 0.0001)) {
-//			Logger(Debug) <<   "(" << p.x() << "," << p.y() << ")" ;
-//			Logger(Debug) << "Height" << h;
-//			new_nodes.push_back(sphn.addNode(p.x(), p.y(), h, 0.0001,  DM::View()));
-//		}
-//		if (!sphn.findNode(p1.x(), p1.y(), 0.0001)) {
-//			Logger(Debug) <<   "(" << p1.x() << "," << p1.y() << ")" ;
-//			Logger(Debug) << "Height" << h;
-//			new_nodes.push_back(sphn.addNode(p1.x(), p1.y(), h, 0.0001,  DM::View()));
-//		}
-		DM::Node * n1 = sphn.addNode(p.x(), p.y(), h, 0.0001,  DM::View());
-		DM::Node * n2 = sphn.addNode(p1.x(), p1.y(), h, 0.0001,  DM::View());
-		sys_tmp.addEdge(n1, n2, view_roof_lines);
-
-	}
-
-	DM::System shapes = DM::CGALGeometry::ShapeFinder(&sys_tmp,view_roof_lines,view_roof_faces, false, 0.0001  );
-
-	const std::vector<Component*>& cmps = shapes.getAllComponentsInView(view_roof_faces);
-	Logger(Debug) << "number of faces in roof " << cmps.size();
-
-	foreach(DM::Component* c, cmps)
-	{
-		DM::Face * f = (DM::Face*)c;
-		std::vector<DM::Node*> faces;
-		//DM::Face * f = shapes.getFace(uuid);
-		std::vector<DM::Node*> nodes_in_face = TBVectorData::getNodeListFromFace(&shapes, f);
-		foreach (DM::Node * n, nodes_in_face) {
-			faces.push_back(sphn.addNode(n->getX(), n->getY(), n->getZ(), 0.0001,  DM::View()));
+	std::vector<std::vector<DM::Node> > roofs = RoofFaces(xy, z0, alpha);
+	DM_GEOMETRY_LOG(DM::Debug) << "number of faces in roof " << (int) roofs.size();
+
+	//Nodes and edges are shared between neighbouring roof faces
+	std::set<std::pair<DM::Node*, DM::Node*> > edges;
+	foreach(const std::vector<DM::Node> & roof, roofs) {
+		std::vector<DM::Node*> nodes;
+		foreach(const DM::Node & n, roof)
+			nodes.push_back(sphn.addNode(n.getX(), n.getY(), n.getZ(), 0.0001, DM::View()));
+		nodes.push_back(nodes[0]);
+
+		for (unsigned int i = 0; i < nodes.size() - 1; i++) {
+			std::pair<DM::Node*, DM::Node*> e(std::min(nodes[i], nodes[i+1]), std::max(nodes[i], nodes[i+1]));
+			if (edges.insert(e).second)
+				sys_tmp.addEdge(nodes[i], nodes[i+1], view_roof_lines);
 		}
-
-		sys_tmp.addFace(faces, view_roof_faces);
+		sys_tmp.addFace(nodes, view_roof_faces);
 	}
 
-
 	return sys_tmp;
 }
 
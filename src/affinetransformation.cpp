@@ -0,0 +1,174 @@
+/**
+ * @file
+ * @author  Christian Urich <christian.urich@gmail.com>
+ * @version 1.0
+ * @section LICENSE
+ *
+ * This file is part of DynaMind
+ *
+ * Copyright (C) 2013  Christian Urich
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "affinetransformation.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define DM_AFFINE_SSE2
+#endif
+
+namespace DM {
+
+//Below this number of points the transformation is not split on threads
+static const int parallelThreshold = 16384;
+static const int blockSize = 4096;
+
+void AffineTransformation::Rotation2D(double alpha, double matrix[6])
+{
+	const double pi =  3.14159265358979323846;
+	double s = sin(alpha/180*pi);
+	double c = cos(alpha/180*pi);
+
+	matrix[0] = c;
+	matrix[1] = -s;
+	matrix[2] = 0;
+	matrix[3] = s;
+	matrix[4] = c;
+	matrix[5] = 0;
+}
+
+void AffineTransformation::RotationZ(double alpha, double matrix[12])
+{
+	double m[6];
+	AffineTransformation::Rotation2D(alpha, m);
+
+	for (int i = 0; i < 12; i++)
+		matrix[i] = 0;
+	matrix[0] = m[0];
+	matrix[1] = m[1];
+	matrix[4] = m[3];
+	matrix[5] = m[4];
+	matrix[10] = 1;
+}
+
+void AffineTransformation::Transform2D(double *x, double *y, unsigned int n, const double matrix[6])
+{
+	int blocks = (n + blockSize - 1) / blockSize;
+
+	#pragma omp parallel for if ((int) n > parallelThreshold)
+	for (int b = 0; b < blocks; b++) {
+		unsigned int i = b * blockSize;
+		unsigned int end = std::min(n, i + blockSize);
+#ifdef DM_AFFINE_SSE2
+		//Two points per register
+		const __m128d m0 = _mm_set1_pd(matrix[0]);
+		const __m128d m1 = _mm_set1_pd(matrix[1]);
+		const __m128d m2 = _mm_set1_pd(matrix[2]);
+		const __m128d m3 = _mm_set1_pd(matrix[3]);
+		const __m128d m4 = _mm_set1_pd(matrix[4]);
+		const __m128d m5 = _mm_set1_pd(matrix[5]);
+		for (; i + 1 < end; i += 2) {
+			__m128d vx = _mm_loadu_pd(x + i);
+			__m128d vy = _mm_loadu_pd(y + i);
+			__m128d rx = _mm_add_pd(_mm_add_pd(_mm_mul_pd(m0, vx), _mm_mul_pd(m1, vy)), m2);
+			__m128d ry = _mm_add_pd(_mm_add_pd(_mm_mul_pd(m3, vx), _mm_mul_pd(m4, vy)), m5);
+			_mm_storeu_pd(x + i, rx);
+			_mm_storeu_pd(y + i, ry);
+		}
+#endif
+		for (; i < end; i++) {
+			double vx = x[i];
+			double vy = y[i];
+			x[i] = matrix[0] * vx + matrix[1] * vy + matrix[2];
+			y[i] = matrix[3] * vx + matrix[4] * vy + matrix[5];
+		}
+	}
+}
+
+void AffineTransformation::Transform2D(double *xy, unsigned int n, const double matrix[6])
+{
+	int blocks = (n + blockSize - 1) / blockSize;
+
+	#pragma omp parallel for if ((int) n > parallelThreshold)
+	for (int b = 0; b < blocks; b++) {
+		unsigned int i = b * blockSize;
+		unsigned int end = std::min(n, i + blockSize);
+#ifdef DM_AFFINE_SSE2
+		//One point per register: (x', y') = (m0, m3) * x + (m1, m4) * y + (m2, m5)
+		const __m128d c0 = _mm_setr_pd(matrix[0], matrix[3]);
+		const __m128d c1 = _mm_setr_pd(matrix[1], matrix[4]);
+		const __m128d t = _mm_setr_pd(matrix[2], matrix[5]);
+		for (; i < end; i++) {
+			__m128d p = _mm_loadu_pd(xy + 2*i);
+			__m128d vx = _mm_unpacklo_pd(p, p);
+			__m128d vy = _mm_unpackhi_pd(p, p);
+			_mm_storeu_pd(xy + 2*i, _mm_add_pd(_mm_add_pd(_mm_mul_pd(c0, vx), _mm_mul_pd(c1, vy)), t));
+		}
+#endif
+		for (; i < end; i++) {
+			double vx = xy[2*i];
+			double vy = xy[2*i+1];
+			xy[2*i] = matrix[0] * vx + matrix[1] * vy + matrix[2];
+			xy[2*i+1] = matrix[3] * vx + matrix[4] * vy + matrix[5];
+		}
+	}
+}
+
+void AffineTransformation::Transform3D(double *xyz, unsigned int n, const double matrix[12])
+{
+	int size_n = n;
+
+	#pragma omp parallel for if (size_n > parallelThreshold)
+	for (int i = 0; i < size_n; i++) {
+		double * p = xyz + 3*i;
+		double vx = p[0];
+		double vy = p[1];
+		double vz = p[2];
+		p[0] = matrix[0] * vx + matrix[1] * vy + matrix[2] * vz + matrix[3];
+		p[1] = matrix[4] * vx + matrix[5] * vy + matrix[6] * vz + matrix[7];
+		p[2] = matrix[8] * vx + matrix[9] * vy + matrix[10] * vz + matrix[11];
+	}
+}
+
+void AffineTransformation::TransformNodes(const std::vector<Node *> &nodes, const double matrix[12])
+{
+	double v[3];
+	for (unsigned int i = 0; i < nodes.size(); i++) {
+		DM::Node * n = nodes[i];
+		n->get(v);
+		n->setX(matrix[0] * v[0] + matrix[1] * v[1] + matrix[2] * v[2] + matrix[3]);
+		n->setY(matrix[4] * v[0] + matrix[5] * v[1] + matrix[6] * v[2] + matrix[7]);
+		n->setZ(matrix[8] * v[0] + matrix[9] * v[1] + matrix[10] * v[2] + matrix[11]);
+	}
+}
+
+void AffineTransformation::TransformNodes(std::vector<Node> &nodes, const double matrix[12])
+{
+	double v[3];
+	for (unsigned int i = 0; i < nodes.size(); i++) {
+		DM::Node & n = nodes[i];
+		n.get(v);
+		n.setX(matrix[0] * v[0] + matrix[1] * v[1] + matrix[2] * v[2] + matrix[3]);
+		n.setY(matrix[4] * v[0] + matrix[5] * v[1] + matrix[6] * v[2] + matrix[7]);
+		n.setZ(matrix[8] * v[0] + matrix[9] * v[1] + matrix[10] * v[2] + matrix[11]);
+	}
+}
+
+}
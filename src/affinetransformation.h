@@ -0,0 +1,67 @@
+/**
+ * @file
+ * @author  Christian Urich <christian.urich@gmail.com>
+ * @version 1.0
+ * @section LICENSE
+ *
+ * This file is part of DynaMind
+ *
+ * Copyright (C) 2013  Christian Urich
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef AFFINETRANSFORMATION_H
+#define AFFINETRANSFORMATION_H
+
+#include <dm.h>
+#include <vector>
+
+namespace DM {
+
+/** @brief In place affine transformations of coordinates and nodes
+ *
+ * 2D matrices are row major 2x3: x' = m[0]*x + m[1]*y + m[2], y' = m[3]*x + m[4]*y + m[5]
+ * 3D matrices are row major 3x4: x' = m[0]*x + m[1]*y + m[2]*z + m[3], ...
+ * Coordinate arrays are transformed in parallel, nodes on the calling thread.
+ */
+class DM_HELPER_DLL_EXPORT AffineTransformation
+{
+public:
+	/** @brief 2D rotation around the origin, alpha in degree counter clockwise */
+	static void Rotation2D(double alpha, double matrix[6]);
+
+	/** @brief 3D rotation around the z axis, alpha in degree counter clockwise */
+	static void RotationZ(double alpha, double matrix[12]);
+
+	/** @brief Transforms n points stored in separate x and y arrays */
+	static void Transform2D(double * x, double * y, unsigned int n, const double matrix[6]);
+
+	/** @brief Transforms n points stored as interleaved x,y coordinates */
+	static void Transform2D(double * xy, unsigned int n, const double matrix[6]);
+
+	/** @brief Transforms n points stored as interleaved x,y,z coordinates */
+	static void Transform3D(double * xyz, unsigned int n, const double matrix[12]);
+
+	/** @brief Transforms the nodes in place */
+	static void TransformNodes(const std::vector<DM::Node*> & nodes, const double matrix[12]);
+
+	/** @brief Transforms the nodes in place */
+	static void TransformNodes(std::vector<DM::Node> & nodes, const double matrix[12]);
+};
+}
+
+#endif // AFFINETRANSFORMATION_H
@@ -31,6 +31,11 @@
 #include <tbvectordata.h>
 #include <cgaltriangulation.h>
 #include <cgalregulartriangulation.h>
+#include <preparedface.h>
+#include <straightskeleton.h>
+#include <affinetransformation.h>
+#include <triangulationcache.h>
+#include <geometrylogger.h>
 
 //CGAL
 #include <CGAL/min_quadrilateral_2.h>
@@ -41,6 +46,12 @@
 #include<CGAL/create_offset_polygons_2.h>
 #include <CGAL/convex_hull_2.h>
 
+//Boost
+#include <boost/geometry.hpp>
+#include <boost/geometry/geometries/point.hpp>
+#include <boost/geometry/geometries/box.hpp>
+#include <boost/geometry/index/rtree.hpp>
+
 namespace DM {
 
 
@@ -148,7 +159,7 @@ DM::System CGALGeometry::ShapeFinder(DM::System * sys, DM::View & id, DM::View &
 	return return_vec;
 }
 
-double CGALGeometry::CalculateMinBoundingBox(std::vector<Node*> nodes, std::vector<DM::Node> & boundingBox, std::vector<double> & size) {
+double CGALGeometry::CalculateMinBoundingBox(const std::vector<Node*> & nodes, std::vector<DM::Node> & boundingBox, std::vector<double> & size) {
 
 	typedef CGAL::Exact_predicates_inexact_constructions_kernel K ;
 	typedef K::Point_2                                          Point_2;
@@ -200,23 +211,166 @@ double CGALGeometry::CalculateMinBoundingBox(std::vector<Node*> nodes, std::vect
 	return angel;
 }
 
-std::vector<std::vector< Node> > CGALGeometry::OffsetPolygon(std::vector<Node*> points, double offset)  {
+double CGALGeometry::MinBoundingBox(const std::vector<double> & xy, std::vector<double> & corners, double & length, double & width)
+{
 	typedef CGAL::Exact_predicates_inexact_constructions_kernel K ;
 	typedef K::Point_2                                          Point_2;
-	typedef CGAL::Aff_transformation_2<K>                       Transformation;
-	typedef CGAL::Polygon_2<K>                                  Polygon_2;
-	typedef CGAL::Polygon_set_2<K>                              Polygon_set_2;
-	typedef CGAL::Polygon_with_holes_2<K>                       Polygon_with_holes_2;
-	typedef std::list<Polygon_with_holes_2>                     Pwh_list_2;
-	typedef CGAL::Straight_skeleton_2<K>                        Ss ;
-	typedef boost::shared_ptr<Polygon_2>                        PolygonPtr ;
-	typedef boost::shared_ptr<Ss>                               SsPtr ;
-	typedef std::vector<PolygonPtr>                             PolygonPtrVector ;
 
-	Polygon_2 poly_s;
-	std::vector<std::vector<DM::Node> > ret_points;
+	const double pi =  3.14159265358979323846;
+	length = -1;
+	width = -1;
+
+	unsigned int s_nodes = xy.size() / 2;
+	if (s_nodes < 3)
+		return -1;
+
+	//Work relative to the first node to avoid problems with big numbers
+	double ox = xy[0];
+	double oy = xy[1];
+	std::vector<Point_2> lpoints;
+	lpoints.reserve(s_nodes);
+	for (unsigned int i = 0; i < s_nodes; i++)
+		lpoints.push_back(Point_2(xy[2*i] - ox, xy[2*i+1] - oy));
+
+	std::vector<Point_2> hull;
+	CGAL::convex_hull_2(lpoints.begin(), lpoints.end(), std::back_inserter(hull));
+	int h = hull.size();
+	if (h < 3)
+		return -1;
+
+	//Rotating calipers, the hull is counter clockwise. For every hull edge the
+	//antipodal vertex (k) and the extremes along the edge (j, m) only move forward.
+	int j = 1;
+	int k = 1;
+	int m = 0;
+	double best_area = -1;
+	double best[8];
+	double best_l = 0;
+	double best_w = 0;
+	double best_angle = 0;
+
+	for (int i = 0; i < h; i++) {
+		const Point_2 & p = hull[i];
+		const Point_2 & q = hull[(i+1) % h];
+		double ux = q.x() - p.x();
+		double uy = q.y() - p.y();
+		double ul = sqrt(ux*ux + uy*uy);
+		if (ul == 0)
+			continue;
+		ux /= ul;
+		uy /= ul;
+
+		int guard = 0;
+		while (guard++ < h && (ux * (hull[(k+1)%h].y() - p.y()) - uy * (hull[(k+1)%h].x() - p.x())) >=
+			   (ux * (hull[k].y() - p.y()) - uy * (hull[k].x() - p.x())))
+			k = (k+1) % h;
+		guard = 0;
+		while (guard++ < h && (ux * (hull[(j+1)%h].x() - p.x()) + uy * (hull[(j+1)%h].y() - p.y())) >=
+			   (ux * (hull[j].x() - p.x()) + uy * (hull[j].y() - p.y())))
+			j = (j+1) % h;
+		if (i == 0)
+			m = k;
+		guard = 0;
+		while (guard++ < h && (ux * (hull[(m+1)%h].x() - p.x()) + uy * (hull[(m+1)%h].y() - p.y())) <=
+			   (ux * (hull[m].x() - p.x()) + uy * (hull[m].y() - p.y())))
+			m = (m+1) % h;
+
+		double max_u = ux * (hull[j].x() - p.x()) + uy * (hull[j].y() - p.y());
+		double min_u = ux * (hull[m].x() - p.x()) + uy * (hull[m].y() - p.y());
+		double height = ux * (hull[k].y() - p.y()) - uy * (hull[k].x() - p.x());
+
+		double l = max_u - min_u;
+		double area = l * height;
+		if (best_area >= 0 && area >= best_area)
+			continue;
+
+		best_area = area;
+		best_l = l;
+		best_w = height;
+		best_angle = atan2(uy, ux) * 180. / pi;
 
+		//Corners counter clockwise, the normal (-uy, ux) points into the hull
+		best[0] = p.x() + ux * min_u;
+		best[1] = p.y() + uy * min_u;
+		best[2] = p.x() + ux * max_u;
+		best[3] = p.y() + uy * max_u;
+		best[4] = best[2] - uy * height;
+		best[5] = best[3] + ux * height;
+		best[6] = best[0] - uy * height;
+		best[7] = best[1] + ux * height;
+	}
+
+	if (best_area < 0)
+		return -1;
+
+	if (best_l < best_w) {
+		best_angle += 90;
+		double tmp_l = best_l;
+		best_l = best_w;
+		best_w = tmp_l;
+	}
+	while (best_angle < 0)
+		best_angle += 180;
+	while (best_angle >= 180)
+		best_angle -= 180;
+
+	corners.resize(8);
+	for (int i = 0; i < 4; i++) {
+		corners[2*i] = best[2*i] + ox;
+		corners[2*i+1] = best[2*i+1] + oy;
+	}
+	length = best_l;
+	width = best_w;
+	return best_angle;
+}
+
+void CGALGeometry::CalculateMinBoundingBoxes(System *sys, View &faceView, std::vector<double> &angles, std::vector<double> &lengths, std::vector<double> &widths, std::vector<double> &corners)
+{
+	const std::vector<DM::Component*> & faces = sys->getAllComponentsInView(faceView);
+	int size_f = faces.size();
+
+	//Copy coordinates into one flat array, offsets point to the first node of every face
+	std::vector<double> xy;
+	std::vector<unsigned int> offsets(size_f + 1, 0);
+	double v[3];
+	for (int i = 0; i < size_f; i++) {
+		std::vector<DM::Node*> nodes = static_cast<DM::Face*>(faces[i])->getNodePointers();
+		unsigned int s_nodes = nodes.size();
+		if (s_nodes > 0 && nodes[0] == nodes[s_nodes-1])
+			s_nodes--;
+		for (unsigned int j = 0; j < s_nodes; j++) {
+			nodes[j]->get(v);
+			xy.push_back(v[0]);
+			xy.push_back(v[1]);
+		}
+		offsets[i+1] = xy.size();
+	}
+
+	angles.assign(size_f, -1);
+	lengths.assign(size_f, -1);
+	widths.assign(size_f, -1);
+	corners.assign(8 * size_f, 0);
+
+	#pragma omp parallel for schedule(dynamic, 64)
+	for (int i = 0; i < size_f; i++) {
+		std::vector<double> face_xy(xy.begin() + offsets[i], xy.begin() + offsets[i+1]);
+		std::vector<double> face_corners;
+		double l = -1;
+		double w = -1;
+		double angle = CGALGeometry::MinBoundingBox(face_xy, face_corners, l, w);
+		if (l < 0)
+			continue;
+		angles[i] = angle;
+		lengths[i] = l;
+		widths[i] = w;
+		for (int j = 0; j < 8; j++)
+			corners[8*i+j] = face_corners[j];
+	}
+}
+
+std::vector<std::vector< Node> > CGALGeometry::OffsetPolygon(std::vector<Node*> points, double offset)  {
 	if (offset == 0) {
+		std::vector<std::vector<DM::Node> > ret_points;
 		std::vector<DM::Node> dmpoly;
 		for (unsigned int i = 0; i < points.size(); i++ ) {
 			dmpoly.push_back(Node(points[i]->getX(), points[i]->getY(), 0));
@@ -224,57 +378,76 @@ std::vector<std::vector< Node> > CGALGeometry::OffsetPolygon(std::vector<Node*>
 		ret_points.push_back(dmpoly);
 		return ret_points;
 	}
-	double v[3];
-	for (unsigned int i = 0; i <  points.size(); i++) {
-		points[i]->get(v);
-		poly_s.push_back(Point_2(v[0], v[1]));
-	}
-
-	if(!poly_s.is_simple()) {
-		Logger(Warning) << "Can't perform offset polygon is not simple";
-		return ret_points;
-	}
-	CGAL::Orientation orient = poly_s.orientation();
-	if (orient == CGAL::CLOCKWISE) {
-		poly_s.reverse_orientation();
-	}
-	SsPtr ss = CGAL::create_interior_straight_skeleton_2(poly_s);
-
-	PolygonPtrVector offset_polygons = CGAL::create_offset_polygons_2<Polygon_2>(offset,*ss);
-
-	foreach(PolygonPtr poly, offset_polygons) {
-		Polygon_2 p = *(poly);
-		std::vector<DM::Node> dmpoly;
-		for (unsigned int i = 0; i < p.size(); i++ ) {
-			dmpoly.push_back(Node(p[i].x(), p[i].y(), 0));
-		}
-		ret_points.push_back(dmpoly);
+	StraightSkeleton ss(points);
+	return ss.offset(offset);
+}
 
-	}
-	return ret_points;
+std::vector<std::vector<std::vector<Node> > > CGALGeometry::OffsetPolygon(std::vector<Node *> points, const std::vector<double> &offsets)
+{
+	StraightSkeleton ss(points);
+	return ss.offset(offsets);
 }
 
 std::vector<DM::Node> CGALGeometry::FaceTriangulation(System *sys, Face *f)
 {
 	std::vector<DM::Node> triangles;
 
-	CGALTriangulation::Triangulation(sys, f, triangles);
+	CGALGeometry::FaceTriangulation(sys, f, triangles);
 	return triangles;
 }
 
 void CGALGeometry::FaceTriangulation(System *sys, Face *f, std::vector<DM::Node> &triangles)
 {
-	CGALTriangulation::Triangulation(sys, f, triangles);
+	IndexedMesh mesh;
+	if (!TriangulationCache::Triangulation(sys, f, mesh)) {
+		triangles.clear();
+		return;
+	}
+	mesh.toTriangleNodes(triangles);
+}
+
+bool CGALGeometry::FaceTriangulation(System *sys, Face *f, IndexedMesh &mesh)
+{
+	return TriangulationCache::Triangulation(sys, f, mesh);
+}
+
+void CGALGeometry::TriangulateView(System *sys, View &view, IndexedMesh &mesh, std::vector<unsigned int> &faceTriangleOffsets)
+{
+	CGALTriangulation::TriangulateView(sys, view, mesh, faceTriangleOffsets);
+}
+
+void CGALGeometry::TriangulateViewConforming(System *sys, View &view, IndexedMesh &mesh, std::vector<int> &triangleFace)
+{
+	CGALTriangulation::TriangulateViewConforming(sys, view, mesh, triangleFace);
 }
 
 std::vector<DM::Node> CGALGeometry::RegularFaceTriangulation(System *sys, Face *f, std::vector<int> & ids, double meshsize)
 {
 	std::vector<DM::Node> triangles;
 
-	CGALRegularTriangulation::Triangulation(sys, f, triangles,  meshsize, ids);
+	IndexedMesh mesh;
+	TriangulationCache::RegularTriangulation(sys, f, meshsize, mesh);
+	for (unsigned int i = 0; i < mesh.numberOfVertices(); i++)
+		triangles.push_back(DM::Node(mesh.vertices[3*i], mesh.vertices[3*i+1], mesh.vertices[3*i+2]));
+	ids.insert(ids.end(), mesh.triangles.begin(), mesh.triangles.end());
 	return triangles;
 }
 
+MeshStatistics CGALGeometry::RegularFaceTriangulation(System *sys, Face *f, const MeshSizeField &field, IndexedMesh &mesh)
+{
+	return CGALRegularTriangulation::Triangulation(sys, f, field, mesh);
+}
+
+void CGALGeometry::RegularFaceTriangulation(System *sys, Face *f, double meshsize, IndexedMesh &mesh, MeshTopology &topology)
+{
+	CGALRegularTriangulation::Triangulation(sys, f, meshsize, mesh, topology);
+}
+
+void CGALGeometry::TiledRegularFaceTriangulation(System *sys, Face *f, double meshsize, double tileSize, IndexedMesh &mesh)
+{
+	CGALRegularTriangulation::TiledTriangulation(sys, f, meshsize, tileSize, mesh);
+}
+
 bool CGALGeometry::DoFacesInterect(DM::Face * f1, DM::Face * f2) {
 	//uses the intersection routine and checks if the return vector empty (no intersection is found)
 	//CGAL dointersection would be performanter but failed the test when checking if a the filling of a hole
@@ -284,7 +457,7 @@ bool CGALGeometry::DoFacesInterect(DM::Face * f1, DM::Face * f2) {
 	DM::Face * f_2 = TBVectorData::CopyFaceGeometryToNewSystem(f2, &workingsys);
 
 	std::vector<DM::Face*> r_faces = CGALGeometry::IntersectFace(&workingsys, f_1, f_2);
-	Logger(Debug) << r_faces.size();
+	DM_GEOMETRY_LOG(DM::Debug) << (int) r_faces.size();
 
 	if (r_faces.size() == 0){
 		return false;
@@ -306,7 +479,7 @@ std::vector<DM::Face*> CGALGeometry::CleanFace(System *sys, Face *f1) {
 			std::vector<DM::Face*> result_faces_tmp = CGALGeometry::BoolOperationFace(sys, f_in, f_h, DM::CGALGeometry::OP_DIFFERENCE);
 			foreach (DM::Face * f_new, result_faces_tmp) {
 				result_faces_next.push_back(f_new);
-				Logger(Debug) << f_new->getNodePointers().size();
+				DM_GEOMETRY_LOG(DM::Debug) << (int) f_new->getNodePointers().size();
 			}
 		}
 		result_faces = result_faces_next;
@@ -495,37 +668,66 @@ std::vector<Face *> CGALGeometry::BoolOperationFace(System *sys, Face *f1, Face
 
 std::vector<DM::Node> CGALGeometry::RotateNodes(std::vector<DM::Node>  nodes, double alpha)
 {
+	double rotate[12];
+	AffineTransformation::RotationZ(alpha, rotate);
+	AffineTransformation::TransformNodes(nodes, rotate);
+	return nodes;
+}
 
-	typedef CGAL::Cartesian<double>         K;
-	typedef CGAL::Aff_transformation_2<K>   Transformation;
-	typedef K::Point_2                  Point;
-
-	std::vector<DM::Node> ressVec;
-	const double pi =  3.14159265358979323846;
-
-	Transformation rotate(CGAL::ROTATION,  sin(alpha/180*pi), cos(alpha/180*pi));
+void CGALGeometry::RotateNodesInPlace(const std::vector<Node *> &nodes, double alpha)
+{
+	double rotate[12];
+	AffineTransformation::RotationZ(alpha, rotate);
+	AffineTransformation::TransformNodes(nodes, rotate);
+}
 
-	foreach (DM::Node n, nodes) {
+bool CGALGeometry::CheckOrientation(const std::vector<DM::Node*> & nodes, bool checkSimple)
+{
+	typedef CGAL::Exact_predicates_inexact_constructions_kernel K;
+	typedef K::Point_2                                          Point;
 
-		Point q(n.getX(), n.getY());
-		q = rotate(q);
+	if (checkSimple && !CGALGeometry::IsSimple(nodes)) {
+		DM::Logger(DM::Warning) << "Polygon is not simple can't check orientation";
+		return true;
+	}
 
-		ressVec.push_back(DM::Node(q.x(), q.y(), n.getZ()));
+	//Skip repeated nodes, this also removes the closing node
+	std::vector<Point> points;
+	points.reserve(nodes.size());
+	double v[3];
+	for (unsigned int i = 0; i < nodes.size(); i++) {
+		nodes[i]->get(v);
+		Point p(v[0], v[1]);
+		if (!points.empty() && points.back() == p)
+			continue;
+		points.push_back(p);
+	}
+	while (points.size() > 1 && points.back() == points.front())
+		points.pop_back();
 
+	int size_n = points.size();
+	if (size_n < 3)
+		return true;
 
+	//The lowest-leftmost vertex is always convex, the turn at this vertex
+	//defines the orientation of the polygon
+	int m = 0;
+	for (int i = 1; i < size_n; i++) {
+		if (points[i].y() < points[m].y() || (points[i].y() == points[m].y() && points[i].x() < points[m].x()))
+			m = i;
+	}
+	CGAL::Orientation orient = CGAL::orientation(points[(m + size_n - 1) % size_n], points[m], points[(m + 1) % size_n]);
+	if (orient == CGAL::CLOCKWISE) {
+		return false;
 	}
-	return ressVec;
+	return true;
 }
 
-bool CGALGeometry::CheckOrientation(std::vector<DM::Node*> nodes)
+bool CGALGeometry::IsSimple(const std::vector<DM::Node*> & nodes)
 {
 	typedef CGAL::Exact_predicates_exact_constructions_kernel K;
 	typedef K::Point_2                                          Point;
 	typedef CGAL::Polygon_2<K>                                  Polygon_2;
-	typedef CGAL::Polygon_set_2<K, std::vector<Point> >         Polygon_set_2;
-	typedef CGAL::Polygon_with_holes_2<K>                       Polygon_with_holes_2;
-	typedef std::list<Polygon_with_holes_2>                     Pwh_list_2;
-
 
 	int size_n1 = nodes.size();
 
@@ -535,16 +737,7 @@ bool CGALGeometry::CheckOrientation(std::vector<DM::Node*> nodes)
 		nodes[i]->get(v);
 		poly1.push_back(Point(v[0], v[1]));
 	}
-	//needs to be simple
-	if (!poly1.is_simple()) {
-		DM::Logger(DM::Warning) << "Polygon is not simple can't check orientation";
-		return true;
-	}
-	CGAL::Orientation orient = poly1.orientation();
-	if (orient == CGAL::CLOCKWISE) {
-		return false;
-	}
-	return true;
+	return poly1.is_simple();
 }
 
 Node CGALGeometry::CalculateCentroid(System *sys, Face *f)
@@ -721,4 +914,85 @@ bool CGALGeometry::NodeWithinFace(Face *f, const Node &n)
 	return true;
 }
 
+std::vector<int> CGALGeometry::PointsInFaces(System *sys, View &nodeView, View &faceView)
+{
+	const std::vector<DM::Component*> & faces = sys->getAllComponentsInView(faceView);
+	const std::vector<DM::Component*> & nodes = sys->getAllComponentsInView(nodeView);
+
+	int size_n = nodes.size();
+	std::vector<double> xy(2 * size_n);
+	double v[3];
+	for (int i = 0; i < size_n; i++) {
+		static_cast<DM::Node*>(nodes[i])->get(v);
+		xy[2*i] = v[0];
+		xy[2*i+1] = v[1];
+	}
+
+	return CGALGeometry::PointsInFaces(xy, faces);
+}
+
+std::vector<int> CGALGeometry::PointsInFaces(const std::vector<double> &xy, const std::vector<Component *> &faces)
+{
+	typedef boost::geometry::model::point<double, 2, boost::geometry::cs::cartesian>   BPoint;
+	typedef boost::geometry::model::box<BPoint>                                         BBox;
+	typedef std::pair<BBox, int>                                                        BValue;
+	typedef boost::geometry::index::rtree<BValue, boost::geometry::index::rstar<16> >   RTree;
+
+	//Faces are read from the system before the parallel part starts
+	int size_f = faces.size();
+	std::vector<PreparedFace> prepared;
+	std::vector<BValue> boxes;
+	prepared.reserve(size_f);
+	boxes.reserve(size_f);
+	for (int i = 0; i < size_f; i++) {
+		prepared.push_back(PreparedFace(static_cast<DM::Face*>(faces[i])));
+		if (prepared[i].isEmpty())
+			continue;
+		double xmin, ymin, xmax, ymax;
+		prepared[i].getBoundingBox(xmin, ymin, xmax, ymax);
+		boxes.push_back(BValue(BBox(BPoint(xmin, ymin), BPoint(xmax, ymax)), i));
+	}
+
+	//Range constructor uses the packing algorithm (bulk loading)
+	RTree rtree(boxes.begin(), boxes.end());
+
+	int size_n = xy.size() / 2;
+	std::vector<int> containingFaces(size_n, -1);
+
+	#pragma omp parallel for schedule(dynamic, 256)
+	for (int i = 0; i < size_n; i++) {
+		std::vector<BValue> candidates;
+		rtree.query(boost::geometry::index::intersects(BPoint(xy[2*i], xy[2*i+1])), std::back_inserter(candidates));
+
+		int found = -1;
+		for (unsigned int j = 0; j < candidates.size(); j++) {
+			int id = candidates[j].second;
+			if (found != -1 && id > found)
+				continue;
+			if (prepared[id].contains(xy[2*i], xy[2*i+1]))
+				found = id;
+		}
+		containingFaces[i] = found;
+	}
+
+	return containingFaces;
+}
+
+void CGALGeometry::LinkPointsInFaces(System *sys, View &nodeView, View &faceView)
+{
+	std::vector<int> containingFaces = CGALGeometry::PointsInFaces(sys, nodeView, faceView);
+
+	const std::vector<DM::Component*> & faces = sys->getAllComponentsInView(faceView);
+	const std::vector<DM::Component*> & nodes = sys->getAllComponentsInView(nodeView);
+
+	int linked = 0;
+	for (unsigned int i = 0; i < containingFaces.size(); i++) {
+		if (containingFaces[i] < 0)
+			continue;
+		nodes[i]->getAttribute(faceView.getName())->addLink(faces[containingFaces[i]], faceView.getName());
+		linked++;
+	}
+	Logger(Debug) << "Linked nodes " << linked << " of " << (int) containingFaces.size();
+}
+
 }
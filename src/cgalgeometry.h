@@ -30,11 +30,14 @@
 #include <dmview.h>
 #include <dmnode.h>
 #include <vector>
+#include <meshsizefield.h>
 
 namespace DM {
 
 class System;
 class Face;
+class IndexedMesh;
+class MeshTopology;
 
 class DM_HELPER_DLL_EXPORT CGALGeometry
 {
@@ -51,21 +54,79 @@ public:
 	/** @brief Calculates minimal bounding box. Returns alpha in degree,
 		 * the 4 nodes of the bounding box and the size (l and w)
 		 * the bounding box is always oriented that l < w;
+		 * alpha is the unsigned angle between the x axis and the first side of the box, +90 if
+		 * that side is the short one, so it lies in [0, 270] and does not tell a long side at
+		 * 30 degree from one at -30 degree. MinBoundingBox and CalculateMinBoundingBoxes return
+		 * the signed direction of the long side in [0, 180) instead.
 		 */
-	static double CalculateMinBoundingBox(std::vector<DM::Node*> nodes, std::vector<DM::Node> &boundingBox, std::vector<double> & size);
+	static double CalculateMinBoundingBox(const std::vector<DM::Node*> & nodes, std::vector<DM::Node> &boundingBox, std::vector<double> & size);
+
+	/** @brief Calculates the minimal bounding box of a polygon given as x,y coordinates with
+	 * rotating calipers on the convex hull. Returns the angle of the long side in degree [0, 180),
+	 * length >= width and the 4 corners (x,y) counter clockwise. Returns -1 if the polygon is degenerated.
+	 * The angle differs from CalculateMinBoundingBox, a long side at -30 degree gives 150 here
+	 * and an unsigned angle (30 or 150) there.
+	 */
+	static double MinBoundingBox(const std::vector<double> & xy, std::vector<double> & corners, double & length, double & width);
+
+	/** @brief Calculates the minimal bounding boxes for all faces in the view in parallel.
+	 * Results are written per face, the corners as 8 values (4 x,y pairs) per face.
+	 * For degenerated faces angle, length and width are -1. Angles follow MinBoundingBox, not
+	 * CalculateMinBoundingBox.
+	 */
+	static void CalculateMinBoundingBoxes(DM::System * sys, DM::View & faceView, std::vector<double> & angles, std::vector<double> & lengths, std::vector<double> & widths, std::vector<double> & corners);
 
 	static std::vector<std::vector<Node> > OffsetPolygon(std::vector<DM::Node*> points, double offset);
 
+	/** @brief Offsets the polygon for every distance in offsets, the straight skeleton is only built once.
+	 * Use DM::StraightSkeleton to keep the skeleton for later offsets.
+	 */
+	static std::vector<std::vector<std::vector<Node> > > OffsetPolygon(std::vector<DM::Node*> points, const std::vector<double> & offsets);
+
 	/** @brief Returns node list that contains the triangulation of the face f.
-		 * Every trinagle is defined by 3 nodes.
+		 * Every trinagle is defined by 3 nodes. Results are cached if a memory
+		 * budget is set for DM::TriangulationCache.
 		 */
 	static std::vector<DM::Node> FaceTriangulation(DM::System * sys, DM::Face * f);
 	static void FaceTriangulation(DM::System * sys, DM::Face * f,  std::vector<DM::Node> &triangles);
 
-	/** @brief Regular Triangulation
+	/** @brief Appends the triangulation of the face f to the indexed mesh, nodes shared by
+		 * several triangles are only stored once. Returns false if the triangulation failed.
+		 */
+	static bool FaceTriangulation(DM::System * sys, DM::Face * f, DM::IndexedMesh & mesh);
+
+	/** @brief Triangulates all faces of the view in parallel into one indexed mesh.
+		 * The triangles of face i are [faceTriangleOffsets[i], faceTriangleOffsets[i+1]).
+		 */
+	static void TriangulateView(DM::System * sys, DM::View & view, DM::IndexedMesh & mesh, std::vector<unsigned int> & faceTriangleOffsets);
+
+	/** @brief Triangulates all faces of the view in the x-y plane in one constrained triangulation.
+		 * Shared boundaries get the same vertices, the mesh is watertight. triangleFace holds the
+		 * index of the face in the view for every triangle, the lowest index if faces overlap.
+		 */
+	static void TriangulateViewConforming(DM::System * sys, DM::View & view, DM::IndexedMesh & mesh, std::vector<int> & triangleFace);
+
+	/** @brief Regular Triangulation, cached like FaceTriangulation
 		 */
 	static std::vector<DM::Node> RegularFaceTriangulation(DM::System * sys, DM::Face * f, std::vector<int> & ids, double meshsize);
 
+	/** @brief Regular triangulation graded by a size field, e.g. DM::EdgeDistanceSizeField for fine
+		 * elements along streets. The result is appended to mesh and not cached. The statistics
+		 * report the triangles compared to a uniform mesh with the minimum size of the field.
+		 */
+	static MeshStatistics RegularFaceTriangulation(DM::System * sys, DM::Face * f, const MeshSizeField & field, DM::IndexedMesh & mesh);
+
+	/** @brief Regular triangulation with the triangle neighbours, edges, areas and centroids
+		 * taken from the triangulation, e.g. as input for solvers. Both outputs are appended
+		 * and not cached.
+		 */
+	static void RegularFaceTriangulation(DM::System * sys, DM::Face * f, double meshsize, DM::IndexedMesh & mesh, DM::MeshTopology & topology);
+
+	/** @brief Regular triangulation of large domains, tiles of tileSize are meshed in parallel and
+		 * merged into one conforming mesh. The result is appended to mesh.
+		 */
+	static void TiledRegularFaceTriangulation(DM::System * sys, DM::Face * f, double meshsize, double tileSize, DM::IndexedMesh & mesh);
+
 	/** @brief Intersect Faces */
 	static std::vector<DM::Face *> IntersectFace(DM::System * sys, DM::Face * f1, DM::Face * f2);
 
@@ -77,11 +138,22 @@ public:
 
 	static std::vector<DM::Face *>  CleanFace(System *sys, Face *f1);
 
-	/** @brief Rotate Nodes */
+	/** @brief Rotate Nodes, alpha in degree */
 	static std::vector<DM::Node> RotateNodes(std::vector<DM::Node> nodes, double alpha);
 
-	/** @brief Check Orientation if CLOCKWISE return true */
-	static bool CheckOrientation(std::vector<DM::Node*> nodes);
+	/** @brief Rotate Nodes in place, alpha in degree. See AffineTransformation for general transformations */
+	static void RotateNodesInPlace(const std::vector<DM::Node*> & nodes, double alpha);
+
+	/** @brief Check Orientation, returns false if CLOCKWISE
+	 *
+	 * The winding is taken from the turn at the lowest-leftmost vertex using a
+	 * filtered orientation predicate. The simplicity check is expensive and
+	 * only performed if checkSimple is set, non simple polygons return true.
+	 */
+	static bool CheckOrientation(const std::vector<DM::Node*> & nodes, bool checkSimple = false);
+
+	/** @brief Returns true if the polygon defined by the nodes is simple */
+	static bool IsSimple(const std::vector<DM::Node*> & nodes);
 
     /** @brief Calculate Centroid */
 	static DM::Node CalculateCentroid(DM::System * sys, DM::Face * f);
@@ -98,6 +170,18 @@ public:
 	/** @brief Calculate Centroid in 2D */
     static DM::Node CalculateCentroid2D( DM::Face * f);
 
+	/** @brief Returns for every node in nodeView the index of the containing face in faceView, -1 if
+	 * the node is not within a face. If faces overlap the face with the lowest index is returned.
+	 * Face candidates are found with a R-tree of the bounding boxes, the queries run in parallel.
+	 */
+	static std::vector<int> PointsInFaces(DM::System * sys, DM::View & nodeView, DM::View & faceView);
+
+	/** @brief Same as above for points given as interleaved x,y coordinates */
+	static std::vector<int> PointsInFaces(const std::vector<double> & xy, const std::vector<DM::Component*> & faces);
+
+	/** @brief Links every node in nodeView to its containing face using the attribute faceView.getName() */
+	static void LinkPointsInFaces(DM::System * sys, DM::View & nodeView, DM::View & faceView);
+
 };
 }
 
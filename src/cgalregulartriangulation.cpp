@@ -28,6 +28,8 @@
 #include <tbvectordata.h>
 #include <dmgeometry.h>
 #include <cgalgeometry.h>
+#include <planeprojection.h>
+#include <meshsizefield.h>
 
 #include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
 #include <CGAL/Constrained_Delaunay_triangulation_2.h>
@@ -35,14 +37,35 @@
 #include <CGAL/Delaunay_mesh_face_base_2.h>
 #include <CGAL/Delaunay_mesh_size_criteria_2.h>
 #include <CGAL/Polygon_2.h>
+#include <CGAL/Triangulation_vertex_base_with_info_2.h>
+#include <CGAL/Triangulation_face_base_with_info_2.h>
+#include <CGAL/Delaunay_mesher_no_edge_refinement_2.h>
+#include <CGAL/Exact_predicates_exact_constructions_kernel.h>
+#include <CGAL/Polygon_with_holes_2.h>
+#include <CGAL/Boolean_set_operations_2.h>
+#include <CGAL/centroid.h>
 #include <CGAL/Cartesian.h>
 #include <iostream>
+#include <cmath>
+#include <algorithm>
+#include <map>
+#include <set>
 
 typedef CGAL::Exact_predicates_inexact_constructions_kernel K;
 //typedef CGAL::Quotient<CGAL::MP_Float>           Number_type;
 //typedef CGAL::Cartesian<Number_type>             K;
-typedef CGAL::Triangulation_vertex_base_2<K> Vb;
-typedef CGAL::Delaunay_mesh_face_base_2<K> Fb;
+/** Vertex id in the output, assigned when the vertex is used the first time */
+struct RegularVertexInfo
+{
+	RegularVertexInfo() : id(-1) {}
+	int id;
+};
+
+typedef CGAL::Triangulation_vertex_base_with_info_2<RegularVertexInfo, K> Vb;
+//Face info holds the nesting level while the domain is marked
+typedef CGAL::Triangulation_face_base_with_info_2<int, K> Fbi;
+typedef CGAL::Constrained_triangulation_face_base_2<K, Fbi> Fbc;
+typedef CGAL::Delaunay_mesh_face_base_2<K, Fbc> Fb;
 typedef CGAL::Triangulation_data_structure_2<Vb, Fb> Tds;
 typedef CGAL::Constrained_Delaunay_triangulation_2<K, Tds> CDT;
 typedef CGAL::Delaunay_mesh_size_criteria_2<CDT> Criteria;
@@ -66,102 +89,548 @@ void insert_polygon(CDT& cdt,const Polygon_2& polygon){
 
 void CGALRegularTriangulation::Triangulation(DM::System * sys, DM::Face * f, std::vector<DM::Node> & triangels, double meshsize, std::vector<int> & ids)
 {
+	DM::IndexedMesh mesh;
+	CGALRegularTriangulation::Triangulation(sys, f, meshsize, mesh);
+	for (unsigned int i = 0; i < mesh.numberOfVertices(); i++)
+		triangels.push_back(DM::Node(mesh.vertices[3*i], mesh.vertices[3*i+1], mesh.vertices[3*i+2]));
+	ids.insert(ids.end(), mesh.triangles.begin(), mesh.triangles.end());
+}
 
-	//Make Place Plane
-	std::vector<DM::Node*> nodeList = TBVectorData::getNodeListFromFace(sys, f);
+namespace {
 
-	double E[3][3];
-	TBVectorData::CorrdinateSystem( DM::Node(0,0,0), DM::Node(1,0,0), DM::Node(0,1,0), E);
+/** Delaunay_mesh_size_criteria_2 with the size bound taken from a size field at the
+ * centroid of every triangle. Triangles are rotated into the plane, the field is
+ * evaluated in world coordinates.
+ */
+class GradedCriteria : public Criteria
+{
+public:
+	typedef Criteria::Quality Quality;
 
-	double E_to[3][3];
+	GradedCriteria(const DM::MeshSizeField & field, const DM::PlaneProjection & projection, double height) :
+		Criteria(0.125, 0),
+		field(&field),
+		projection(&projection),
+		height(height),
+		minSize(field.minimumSize())
+	{
+	}
 
-	TBVectorData::CorrdinateSystem( *(nodeList[0]), *(nodeList[1]), *(nodeList[nodeList.size()-2]), E_to);
+	class Is_bad : public Criteria::Is_bad
+	{
+	public:
+		Is_bad(const Criteria::Is_bad & is_bad, const GradedCriteria * criteria) :
+			Criteria::Is_bad(is_bad),
+			criteria(criteria)
+		{
+		}
+
+		CGAL::Mesh_2::Face_badness operator()(const CDT::Face_handle & fh, Quality & q) const
+		{
+			//Angle test, without size bound the base sets q.first to 1
+			CGAL::Mesh_2::Face_badness badness = Criteria::Is_bad::operator()(fh, q);
 
-	double alphas[3][3];
-	TBVectorData::RotationMatrix(E, E_to, alphas);
+			const Point & pa = fh->vertex(0)->point();
+			const Point & pb = fh->vertex(1)->point();
+			const Point & pc = fh->vertex(2)->point();
+			double v_t[3] = {(pa.x() + pb.x() + pc.x()) / 3., (pa.y() + pb.y() + pc.y()) / 3., criteria->height};
+			double v[3];
+			criteria->projection->fromPlane(v_t, v);
+			//Sizes below the minimum of the field would never be reached
+			double size = std::max(criteria->field->size(v[0], v[1]), criteria->minSize);
 
-	double alphas_t[3][3];
-	for (int i = 0; i < 3; i++){
-		for (int j = 0; j < 3; j++){
-			alphas_t[j][i] =  alphas[i][j];
+			double max_sq_length = std::max(CGAL::squared_distance(pa, pb),
+											std::max(CGAL::squared_distance(pb, pc), CGAL::squared_distance(pc, pa)));
+			q.first = max_sq_length / (size * size);
+			if (q.first > 1) {
+				q.first = 1;
+				return CGAL::Mesh_2::IMPERATIVELY_BAD;
+			}
+			return badness;
 		}
-	}
 
-	DM::System transformedSys;
+	private:
+		const GradedCriteria * criteria;
+	};
 
-	std::vector<DM::Node*> ns_t;
-	double const_height;
-	for (unsigned int i = 0; i < nodeList.size(); i++) {
-		DM::Node n = *(nodeList[i]);
-		DM::Node n_t =  TBVectorData::RotateVector(alphas, n);
-		ns_t.push_back(transformedSys.addNode(n_t));
-		const_height = n_t.getZ();
+	Is_bad is_bad_object() const
+	{
+		return Is_bad(Criteria::is_bad_object(), this);
 	}
 
-	DM::Face * f_t = transformedSys.addFace(ns_t);
+private:
+	const DM::MeshSizeField * field;
+	const DM::PlaneProjection * projection;
+	double height;
+	double minSize;
+};
+
+/** Rotates the face into the plane and inserts the outer ring and the holes, seeds are placed in the holes */
+void prepare(DM::System * sys, DM::Face * f, CDT & cdt, std::list<Point> & list_of_seeds, DM::PlaneProjection & projection, double & const_height)
+{
+	//Make Place Plane
+	std::vector<DM::Node*> nodeList = TBVectorData::getNodeListFromFace(sys, f);
+
+	projection = DM::PlaneProjection(nodeList, *(nodeList[nodeList.size()-2]), true);
 
-	CDT cdt;
 	Polygon_2 polygon1;
+	double v[3];
+	double v_t[3];
+	foreach(DM::Node* n, nodeList) {
+		n->get(v);
+		projection.toPlane(v, v_t);
+		polygon1.push_back(Point(v_t[0], v_t[1]));
+		const_height = v_t[2];
+	}
 
-	foreach(DM::Node* n, f_t->getNodePointers())
-		polygon1.push_back(Point(n->getX(),n->getY()));
 	//Insert the polyons into a constrained triangulation
-
 	insert_polygon(cdt,polygon1);
-	std::list<Point> list_of_seeds;
 	//Add Holes: Holes use the same transormation matrix
 
 	foreach(DM::Face* hole, f->getHolePointers())
 	{
-		std::vector<DM::Node* > nodes_h;
+		Polygon_2 hole_p;
 		foreach(DM::Node* n, hole->getNodePointers())
 		{
-			DM::Node n_t = TBVectorData::RotateVector(alphas, *n);
-			nodes_h.push_back(transformedSys.addNode(n_t));
-		}
-		DM::Face * f_h = transformedSys.addFace(nodes_h);
-		DM::Node center_h = DM::CGALGeometry::CalculateCentroid(&transformedSys, f_h);
-		list_of_seeds.push_back(Point(center_h.getX(), center_h.getY()));
-		Polygon_2 hole_p;
-		for (unsigned int  i = 0; i <nodes_h.size(); i++ ) {
-			DM::Node * n = nodes_h[i];
-			hole_p.push_back(Point(n->getX(),n->getY()));
+			n->get(v);
+			projection.toPlane(v, v_t);
+			hole_p.push_back(Point(v_t[0], v_t[1]));
 		}
+		if (hole_p.is_empty())
+			continue;
+		list_of_seeds.push_back(CGAL::centroid(hole_p.vertices_begin(), hole_p.vertices_end()));
 		insert_polygon(cdt,hole_p);
 	}
+}
 
-	CGAL::refine_Delaunay_mesh_2(cdt, list_of_seeds.begin(), list_of_seeds.end(),
-								 Criteria(0.125, meshsize));
+/** Ids are assigned in order of the first use, vertices are written in one pass.
+ * If topology is set the adjacency is taken from the faces of the CDT, the face info
+ * holds the triangle index.
+ */
+void writeMesh(CDT & cdt, const DM::PlaneProjection & projection, double const_height, DM::IndexedMesh & mesh, DM::MeshTopology * topology = 0)
+{
+	unsigned int offset = mesh.numberOfVertices();
+	int count = 0;
+	double v[3];
+	double v_t[3];
 
-	int count=0;
-	DM::System nodesearch;
-	DM::SpatialNodeHashMap spnh(&nodesearch, 0.1);
-	std::map<DM::Node * , int> nodeids;
-	std::map<int, DM::Node * > idsnode;
+	if (topology) {
+		int t = mesh.numberOfTriangles();
+		for (CDT::All_faces_iterator fit = cdt.all_faces_begin(); fit != cdt.all_faces_end(); ++fit)
+			fit->info() = (!cdt.is_infinite(fit) && fit->is_in_domain()) ? t++ : -1;
+	}
 
 	for (CDT::Finite_faces_iterator fit=cdt.finite_faces_begin();
 		 fit!=cdt.finite_faces_end();++fit){
-		if (fit->is_in_domain() ) {
-			for (int i = 0; i < 3; i++){
-				bool newlyAdded = false;
-				if (!spnh.findNode(CGAL::to_double(fit->vertex(i)->point().x()),  CGAL::to_double(fit->vertex(i)->point().y()), 0.001)) {
-					newlyAdded = true;
-				}
-				DM::Node * n = spnh.addNode(CGAL::to_double(fit->vertex(i)->point().x()),  CGAL::to_double(fit->vertex(i)->point().y()), const_height, 0.001);
-				if (newlyAdded)  {
-					idsnode[count] = n;
-					nodeids[n] = count++;
+		if (!fit->is_in_domain() )
+			continue;
+		unsigned int t[3];
+		for (int i = 0; i < 3; i++){
+			Vertex_handle vh = fit->vertex(i);
+			if (vh->info().id == -1) {
+				vh->info().id = count++;
+				v_t[0] = vh->point().x();
+				v_t[1] = vh->point().y();
+				v_t[2] = const_height;
+				projection.fromPlane(v_t, v);
+				mesh.addVertex(v[0], v[1], v[2]);
+			}
+			t[i] = offset + vh->info().id;
+		}
+		mesh.addTriangle(t[0], t[1], t[2]);
 
-				}
-				ids.push_back(nodeids[n]);
+		if (!topology)
+			continue;
+		int id = fit->info();
+		for (int i = 0; i < 3; i++) {
+			CDT::Face_handle n = fit->neighbor(i);
+			int nid = n->info();
+			topology->neighbours.push_back(nid);
+			//Edges are created by the first triangle, the second one looks them up
+			if (nid != -1 && nid < id) {
+				topology->triangleEdges.push_back(topology->triangleEdges[3*nid + n->index(fit)]);
+				continue;
 			}
+			topology->triangleEdges.push_back(topology->numberOfEdges());
+			topology->edges.push_back(t[(i+1)%3]);
+			topology->edges.push_back(t[(i+2)%3]);
+			topology->edgeTriangles.push_back(id);
+			topology->edgeTriangles.push_back(nid);
+			topology->boundary.push_back(nid == -1);
 		}
+		double c[3] = {0, 0, 0};
+		for (int i = 0; i < 3; i++) {
+			for (int j = 0; j < 3; j++)
+				c[j] += mesh.vertices[3*t[i]+j] / 3.;
+		}
+		topology->centroids.insert(topology->centroids.end(), c, c+3);
+		topology->areas.push_back(cdt.triangle(fit).area());
 	}
-	for (int i = 0; i < count; i++) {
-		DM::Node * n = idsnode[i];
-		triangels.push_back(TBVectorData::RotateVector(alphas_t, DM::Node(n->getX(), n->getY(), n->getZ())));
+}
+}
+
+void CGALRegularTriangulation::Triangulation(DM::System *sys, DM::Face *f, double meshsize, DM::IndexedMesh &mesh)
+{
+	CDT cdt;
+	std::list<Point> list_of_seeds;
+	DM::PlaneProjection projection;
+	double const_height = 0;
+	prepare(sys, f, cdt, list_of_seeds, projection, const_height);
+
+	CGAL::refine_Delaunay_mesh_2(cdt, list_of_seeds.begin(), list_of_seeds.end(),
+								 Criteria(0.125, meshsize));
+
+	writeMesh(cdt, projection, const_height, mesh);
+}
+
+void CGALRegularTriangulation::Triangulation(DM::System *sys, DM::Face *f, double meshsize, DM::IndexedMesh &mesh, DM::MeshTopology &topology)
+{
+	CDT cdt;
+	std::list<Point> list_of_seeds;
+	DM::PlaneProjection projection;
+	double const_height = 0;
+	prepare(sys, f, cdt, list_of_seeds, projection, const_height);
+
+	CGAL::refine_Delaunay_mesh_2(cdt, list_of_seeds.begin(), list_of_seeds.end(),
+								 Criteria(0.125, meshsize));
+
+	writeMesh(cdt, projection, const_height, mesh, &topology);
+}
+
+DM::MeshStatistics CGALRegularTriangulation::Triangulation(DM::System *sys, DM::Face *f, const DM::MeshSizeField &field, DM::IndexedMesh &mesh)
+{
+	if (field.minimumSize() <= 0) {
+		DM::Logger(DM::Warning) << "Minimum size of the mesh size field has to be larger than 0";
+		DM::MeshStatistics stats;
+		stats.triangles = 0;
+		stats.uniformTriangles = 0;
+		stats.area = 0;
+		return stats;
 	}
 
+	CDT cdt;
+	std::list<Point> list_of_seeds;
+	DM::PlaneProjection projection;
+	double const_height = 0;
+	prepare(sys, f, cdt, list_of_seeds, projection, const_height);
+
+	GradedCriteria criteria(field, projection, const_height);
+	CGAL::refine_Delaunay_mesh_2(cdt, list_of_seeds.begin(), list_of_seeds.end(), criteria);
+
+	unsigned int triangles_before = mesh.numberOfTriangles();
+	writeMesh(cdt, projection, const_height, mesh);
+
+	//A uniform mesh is estimated with equilateral triangles of the minimum size
+	DM::MeshStatistics stats;
+	stats.area = 0;
+	for (CDT::Finite_faces_iterator fit=cdt.finite_faces_begin(); fit!=cdt.finite_faces_end();++fit) {
+		if (fit->is_in_domain())
+			stats.area += cdt.triangle(fit).area();
+	}
+	stats.triangles = mesh.numberOfTriangles() - triangles_before;
+	double minSize = field.minimumSize();
+	stats.uniformTriangles = minSize > 0 ? (unsigned int) std::ceil(stats.area / (std::sqrt(3.) / 4. * minSize * minSize)) : stats.triangles;
+
+	DM::Logger(DM::Debug) << "Graded mesh " << (int) stats.triangles << " triangles, uniform mesh estimated with " << (int) stats.uniformTriangles;
+	return stats;
+}
+
+namespace {
+
+typedef CGAL::Exact_predicates_exact_constructions_kernel      EK;
+typedef CGAL::Polygon_2<EK>                                    EPolygon_2;
+typedef CGAL::Polygon_with_holes_2<EK>                         EPolygon_with_holes_2;
+typedef std::vector<Point>                                     Ring;
+
+/** Piece of the domain within one tile, first ring is the outer boundary */
+struct TilePiece
+{
+	std::vector<Ring> rings;
+};
+
+void toRing(const EPolygon_2 & p, Ring & ring)
+{
+	for (EPolygon_2::Vertex_const_iterator it = p.vertices_begin(); it != p.vertices_end(); ++it)
+		ring.push_back(Point(CGAL::to_double(it->x()), CGAL::to_double(it->y())));
+}
+
+EPolygon_2 toExactPolygon(const Polygon_2 & p, bool counterclockwise)
+{
+	EPolygon_2 ep;
+	for (Polygon_2::Vertex_const_iterator it = p.vertices_begin(); it != p.vertices_end(); ++it) {
+		EK::Point_2 ept(it->x(), it->y());
+		if (ep.is_empty() || ep[ep.size()-1] != ept)
+			ep.push_back(ept);
+	}
+	while (ep.size() > 1 && ep[0] == ep[ep.size()-1])
+		ep.erase(ep.vertices_end() - 1);
+	if (ep.size() >= 3 && ep.is_counterclockwise_oriented() != counterclockwise)
+		ep.reverse_orientation();
+	return ep;
+}
+
+/** Points on a tile line collected from all pieces, keyed by the line coordinate */
+typedef std::map<double, std::vector<double> > LinePoints;
+
+/** Points that split the segment a..b on a tile line. a and b are points of the line, every
+ * gap between consecutive points of the line is split into equal parts of at most meshsize.
+ * Both sides of a tile line see the same points, shared segments are split identically.
+ */
+void splitOnLine(double a, double b, const std::vector<double> & linePoints, double meshsize, std::vector<double> & split)
+{
+	double lo = std::min(a, b);
+	double hi = std::max(a, b);
+	std::vector<double> points;
+	std::vector<double>::const_iterator it = std::lower_bound(linePoints.begin(), linePoints.end(), lo);
+	double last = lo;
+	for (; it != linePoints.end() && *it <= hi; ++it) {
+		if (*it <= last)
+			continue;
+		int n = (int) std::ceil((*it - last) / meshsize);
+		for (int j = 1; j < n; j++)
+			points.push_back(last + (*it - last) * j / n);
+		if (*it < hi)
+			points.push_back(*it);
+		last = *it;
+	}
+	if (a > b)
+		std::reverse(points.begin(), points.end());
+	split.swap(points);
 }
 
+/** Inserts the ring with all edges split to at most meshsize, edges on tile lines are split
+ * with splitOnLine, all others with equal parts starting from the lexicographically smaller end.
+ */
+void insertSplitRing(CDT & cdt, const Ring & ring, const std::set<double> & xlines, const std::set<double> & ylines,
+					 const LinePoints & verticalPoints, const LinePoints & horizontalPoints, double meshsize)
+{
+	Polygon_2 split;
+	std::vector<double> t;
+	for (unsigned int i = 0; i < ring.size(); i++) {
+		const Point & p = ring[i];
+		const Point & q = ring[(i+1) % ring.size()];
+		split.push_back(p);
+		if (p.x() == q.x() && xlines.count(p.x())) {
+			splitOnLine(p.y(), q.y(), verticalPoints.find(p.x())->second, meshsize, t);
+			for (unsigned int j = 0; j < t.size(); j++)
+				split.push_back(Point(p.x(), t[j]));
+			continue;
+		}
+		if (p.y() == q.y() && ylines.count(p.y())) {
+			splitOnLine(p.x(), q.x(), horizontalPoints.find(p.y())->second, meshsize, t);
+			for (unsigned int j = 0; j < t.size(); j++)
+				split.push_back(Point(t[j], p.y()));
+			continue;
+		}
+		int n = (int) std::ceil(std::sqrt(CGAL::squared_distance(p, q)) / meshsize);
+		bool forward = p < q;
+		const Point & s = forward ? p : q;
+		const Point & e = forward ? q : p;
+		std::vector<Point> inner;
+		for (int j = 1; j < n; j++)
+			inner.push_back(Point(s.x() + (e.x() - s.x()) * j / n, s.y() + (e.y() - s.y()) * j / n));
+		if (!forward)
+			std::reverse(inner.begin(), inner.end());
+		for (unsigned int j = 0; j < inner.size(); j++)
+			split.push_back(inner[j]);
+	}
+	insert_polygon(cdt, split);
+}
 
+/** Sets the nesting level of the faces connected to start with non constrained edges */
+void markNesting(CDT & cdt, CDT::Face_handle start, int index, std::list<CDT::Edge> & border)
+{
+	std::list<CDT::Face_handle> queue;
+	start->info() = index;
+	queue.push_back(start);
+	while (!queue.empty()) {
+		CDT::Face_handle fh = queue.front();
+		queue.pop_front();
+		for (int i = 0; i < 3; i++) {
+			CDT::Edge e(fh, i);
+			CDT::Face_handle n = fh->neighbor(i);
+			if (n->info() != -1)
+				continue;
+			if (cdt.is_constrained(e)) {
+				border.push_back(e);
+			} else {
+				n->info() = index;
+				queue.push_back(n);
+			}
+		}
+	}
+}
+
+/** Marks the nesting level like CGALTriangulation::mark_domains, every connected part of the
+ * domain (odd level) gets one seed at the centroid of its first face
+ */
+void domainSeeds(CDT & cdt, std::list<Point> & seeds)
+{
+	for (CDT::All_faces_iterator it = cdt.all_faces_begin(); it != cdt.all_faces_end(); ++it)
+		it->info() = -1;
+
+	std::list<CDT::Edge> border;
+	markNesting(cdt, cdt.infinite_face(), 0, border);
+	while (!border.empty()) {
+		CDT::Edge e = border.front();
+		border.pop_front();
+		CDT::Face_handle n = e.first->neighbor(e.second);
+		if (n->info() != -1)
+			continue;
+		int level = e.first->info() + 1;
+		if (level % 2 == 1) {
+			const Point & pa = n->vertex(0)->point();
+			const Point & pb = n->vertex(1)->point();
+			const Point & pc = n->vertex(2)->point();
+			seeds.push_back(Point((pa.x() + pb.x() + pc.x()) / 3., (pa.y() + pb.y() + pc.y()) / 3.));
+		}
+		markNesting(cdt, n, level, border);
+	}
+}
+}
+
+void CGALRegularTriangulation::TiledTriangulation(DM::System *sys, DM::Face *f, double meshsize, double tileSize, DM::IndexedMesh &mesh)
+{
+	if (meshsize <= 0) {
+		DM::Logger(DM::Warning) << "Mesh size has to be larger than 0";
+		return;
+	}
+
+	std::vector<DM::Node*> nodeList = TBVectorData::getNodeListFromFace(sys, f);
+	DM::PlaneProjection projection(nodeList, *(nodeList[nodeList.size()-2]), true);
+	double const_height = 0;
+
+	//Domain in the plane, exact for the clipping
+	double v[3];
+	double v_t[3];
+	Polygon_2 outer;
+	foreach(DM::Node* n, nodeList) {
+		n->get(v);
+		projection.toPlane(v, v_t);
+		outer.push_back(Point(v_t[0], v_t[1]));
+		const_height = v_t[2];
+	}
+	EPolygon_with_holes_2 domain(toExactPolygon(outer, true));
+	if (domain.outer_boundary().size() < 3)
+		return;
+	foreach(DM::Face* hole, f->getHolePointers()) {
+		Polygon_2 hole_p;
+		foreach(DM::Node* n, hole->getNodePointers()) {
+			n->get(v);
+			projection.toPlane(v, v_t);
+			hole_p.push_back(Point(v_t[0], v_t[1]));
+		}
+		EPolygon_2 h = toExactPolygon(hole_p, false);
+		if (h.size() >= 3)
+			domain.add_hole(h);
+	}
+
+	//Tile lines, the outer lines lie beyond the domain
+	CGAL::Bbox_2 box = outer.bbox();
+	if (tileSize <= 0)
+		tileSize = std::max(box.xmax() - box.xmin(), box.ymax() - box.ymin());
+	std::vector<double> xl;
+	std::vector<double> yl;
+	xl.push_back(box.xmin() - 1);
+	yl.push_back(box.ymin() - 1);
+	for (int i = 1; box.xmin() + i * tileSize < box.xmax(); i++)
+		xl.push_back(box.xmin() + i * tileSize);
+	for (int i = 1; box.ymin() + i * tileSize < box.ymax(); i++)
+		yl.push_back(box.ymin() + i * tileSize);
+	xl.push_back(box.xmax() + 1);
+	yl.push_back(box.ymax() + 1);
+	std::set<double> xlines(xl.begin() + 1, xl.end() - 1);
+	std::set<double> ylines(yl.begin() + 1, yl.end() - 1);
+
+	//Clipping uses the exact kernel and runs serial
+	std::vector<TilePiece> pieces;
+	for (unsigned int i = 0; i + 1 < xl.size(); i++) {
+		for (unsigned int j = 0; j + 1 < yl.size(); j++) {
+			EPolygon_2 tile;
+			tile.push_back(EK::Point_2(xl[i], yl[j]));
+			tile.push_back(EK::Point_2(xl[i+1], yl[j]));
+			tile.push_back(EK::Point_2(xl[i+1], yl[j+1]));
+			tile.push_back(EK::Point_2(xl[i], yl[j+1]));
+			std::list<EPolygon_with_holes_2> clipped;
+			CGAL::intersection(domain, tile, std::back_inserter(clipped));
+			foreach(const EPolygon_with_holes_2 & c, clipped) {
+				TilePiece piece;
+				piece.rings.push_back(Ring());
+				toRing(c.outer_boundary(), piece.rings.back());
+				for (EPolygon_with_holes_2::Hole_const_iterator h = c.holes_begin(); h != c.holes_end(); ++h) {
+					piece.rings.push_back(Ring());
+					toRing(*h, piece.rings.back());
+				}
+				pieces.push_back(piece);
+			}
+		}
+	}
+
+	//Vertices on the tile lines from both sides
+	LinePoints verticalPoints;
+	LinePoints horizontalPoints;
+	for (std::set<double>::const_iterator it = xlines.begin(); it != xlines.end(); ++it)
+		verticalPoints[*it];
+	for (std::set<double>::const_iterator it = ylines.begin(); it != ylines.end(); ++it)
+		horizontalPoints[*it];
+	foreach(const TilePiece & piece, pieces) {
+		foreach(const Ring & ring, piece.rings) {
+			foreach(const Point & p, ring) {
+				if (xlines.count(p.x()))
+					verticalPoints[p.x()].push_back(p.y());
+				if (ylines.count(p.y()))
+					horizontalPoints[p.y()].push_back(p.x());
+			}
+		}
+	}
+	for (LinePoints::iterator it = verticalPoints.begin(); it != verticalPoints.end(); ++it) {
+		std::sort(it->second.begin(), it->second.end());
+		it->second.erase(std::unique(it->second.begin(), it->second.end()), it->second.end());
+	}
+	for (LinePoints::iterator it = horizontalPoints.begin(); it != horizontalPoints.end(); ++it) {
+		std::sort(it->second.begin(), it->second.end());
+		it->second.erase(std::unique(it->second.begin(), it->second.end()), it->second.end());
+	}
+
+	//Every piece is meshed on its own, boundary edges are never split by the mesher
+	int size_p = pieces.size();
+	std::vector<DM::IndexedMesh> parts(size_p);
+	DM::PlaneProjection identity;
+	#pragma omp parallel for schedule(dynamic, 1)
+	for (int i = 0; i < size_p; i++) {
+		CDT cdt;
+		foreach(const Ring & ring, pieces[i].rings)
+			insertSplitRing(cdt, ring, xlines, ylines, verticalPoints, horizontalPoints, meshsize);
+		std::list<Point> seeds;
+		domainSeeds(cdt, seeds);
+
+		CGAL::Delaunay_mesher_no_edge_refinement_2<CDT, Criteria> mesher(cdt, Criteria(0.125, meshsize));
+		mesher.set_seeds(seeds.begin(), seeds.end(), true);
+		mesher.refine_mesh();
+		writeMesh(cdt, identity, 0, parts[i]);
+	}
+
+	//Vertices on shared tile lines are identical and welded
+	std::map<std::pair<double, double>, unsigned int> welded;
+	for (int i = 0; i < size_p; i++) {
+		const DM::IndexedMesh & part = parts[i];
+		std::vector<unsigned int> ids(part.numberOfVertices());
+		for (unsigned int j = 0; j < part.numberOfVertices(); j++) {
+			std::pair<double, double> key(part.vertices[3*j], part.vertices[3*j+1]);
+			std::map<std::pair<double, double>, unsigned int>::const_iterator it = welded.find(key);
+			if (it != welded.end()) {
+				ids[j] = it->second;
+				continue;
+			}
+			v_t[0] = key.first;
+			v_t[1] = key.second;
+			v_t[2] = const_height;
+			projection.fromPlane(v_t, v);
+			ids[j] = mesh.addVertex(v[0], v[1], v[2]);
+			welded[key] = ids[j];
+		}
+		for (unsigned int j = 0; j < part.numberOfTriangles(); j++)
+			mesh.addTriangle(ids[part.triangles[3*j]], ids[part.triangles[3*j+1]], ids[part.triangles[3*j+2]]);
+	}
+	DM::Logger(DM::Debug) << "Tiled mesh with " << size_p << " pieces";
+}
@@ -28,11 +28,32 @@
 #define CGALREGULARTRIANGULATION_H
 
 #include <dm.h>
+#include <indexedmesh.h>
+#include <meshsizefield.h>
+#include <meshtopology.h>
 
 class DM_HELPER_DLL_EXPORT CGALRegularTriangulation
 {
 public:
 	static void Triangulation(DM::System * sys, DM::Face * f, std::vector<DM::Node> & triangels, double meshsize,  std::vector<int> & ids);
+
+	/** @brief Appends the refined triangulation to mesh, vertices are shared between triangles */
+	static void Triangulation(DM::System * sys, DM::Face * f, double meshsize, DM::IndexedMesh & mesh);
+
+	/** @brief Appends the refined triangulation to mesh and its adjacency to topology.
+	 * Triangle and vertex indices in topology refer to mesh, both have to be extended together.
+	 */
+	static void Triangulation(DM::System * sys, DM::Face * f, double meshsize, DM::IndexedMesh & mesh, DM::MeshTopology & topology);
+
+	/** @brief Appends the triangulation refined with the local size of field to mesh */
+	static DM::MeshStatistics Triangulation(DM::System * sys, DM::Face * f, const DM::MeshSizeField & field, DM::IndexedMesh & mesh);
+
+	/** @brief Appends the triangulation with mesh size to mesh, the domain is split into tiles of
+	 * tileSize that are meshed in parallel. Edges on the tile borders are split the same way on
+	 * both sides before meshing and are not refined, the merged mesh is conforming.
+	 * A tileSize <= 0 uses one tile.
+	 */
+	static void TiledTriangulation(DM::System * sys, DM::Face * f, double meshsize, double tileSize, DM::IndexedMesh & mesh);
 };
 
 #endif // CGALREGULARTRIANGULATION_H
@@ -38,8 +38,22 @@ class DM_HELPER_DLL_EXPORT CGALSkeletonisation
 
 public:
 	//CGALSkeletonisation();
+	/** @brief Returns a system with the roof faces (view Roof) and roof edges (view Roof_Edges)
+	 * over the footprint f with the slope alpha in degrees */
 	static DM::System StraightSkeletonisation(System *sys, Face *f, double alpha);
 
+	/** @brief Returns one roof face per edge of the footprint xy (x,y coordinates), taken from
+	 * the faces of the straight skeleton. The height of a vertex is z0 + time * tan(alpha), with
+	 * alpha in degrees. Faces are counter clockwise and not closed.
+	 */
+	static std::vector<std::vector<DM::Node> > RoofFaces(const std::vector<double> & xy, double z0, double alpha);
+
+	/** @brief Same as above without DM::Node, safe to call from worker threads. The vertices of
+	 * face i are xyz[3*faceOffsets[i]] to xyz[3*faceOffsets[i+1]-1]. Returns false if the
+	 * footprint is not simple.
+	 */
+	static bool RoofFaces(const std::vector<double> & xy, double z0, double alpha, std::vector<double> & xyz, std::vector<unsigned int> & faceOffsets);
+
 };
 }
 
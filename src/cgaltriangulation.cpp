@@ -27,6 +27,9 @@
 #include "cgaltriangulation.h"
 #include <tbvectordata.h>
 #include <dmgeometry.h>
+#include <cgalgeometry.h>
+#include <algorithm>
+#include <CGAL/Polygon_2_algorithms.h>
 
 void CGALTriangulation::mark_domains(CDT& ct,  CDT::Face_handle start, int index, std::list<CDT::Edge>& border)
 {
@@ -77,96 +80,346 @@ void CGALTriangulation::mark_domains(CDT& cdt)
 	}
 }
 
-void insert_polygon(CDT& cdt,const Polygon_2& polygon){
-	if ( polygon.is_empty() ) return;
-	CDT::Vertex_handle v_prev=cdt.insert(*boost::prior(polygon.vertices_end()));
-	for (Polygon_2::Vertex_iterator vit=polygon.vertices_begin();
-		 vit!=polygon.vertices_end();++vit)
+//Inserts the ring as constraints, new vertices get the z value and the index of their node.
+//Duplicated points keep the info of the first node, a closing node is allowed
+int insert_polygon(CDT& cdt, const double * xyz, unsigned int n, int index){
+	if ( n == 0 ) return index;
+	CDT::Vertex_handle v_first;
+	CDT::Vertex_handle v_prev;
+	for (unsigned int i = 0; i < n; i++)
 	{
-		CDT::Vertex_handle vh=cdt.insert(*vit);
-		cdt.insert_constraint(vh,v_prev);
+		const double * v = xyz + 3*i;
+		CDT::Vertex_handle vh=cdt.insert(Point(v[0], v[1]));
+		if (vh->info().index == -1) {
+			vh->info().z = v[2];
+			vh->info().index = index++;
+		}
+		if (i == 0)
+			v_first = vh;
+		else if (vh != v_prev)
+			cdt.insert_constraint(vh,v_prev);
 		v_prev=vh;
 	}
+	if (v_first != v_prev)
+		cdt.insert_constraint(v_first,v_prev);
+	return index;
 }
 
-void CGALTriangulation::Triangulation(DM::System *sys, DM::Face *f, std::vector<DM::Node> & triangles)
+void CGALTriangulation::PrepareFace(DM::System *sys, DM::Face *f, FaceRings &rings)
 {
-
 	//Make Place Plane
 	std::vector<DM::Node*> nodeList = TBVectorData::getNodeListFromFace(sys, f);
+	rings.projection = DM::PlaneProjection(nodeList, true);
+	rings.xyz.clear();
+	rings.original.clear();
+	rings.ringEnds.clear();
 
-	double E[3][3];
-	TBVectorData::CorrdinateSystem( DM::Node(0,0,0), DM::Node(1,0,0), DM::Node(0,1,0), E);
+	double v[3];
+	foreach(DM::Node* n, nodeList) {
+		n->get(v);
+		rings.original.insert(rings.original.end(), v, v + 3);
+		rings.xyz.resize(rings.xyz.size() + 3);
+		rings.projection.toPlane(v, &rings.xyz[rings.xyz.size() - 3]);
+	}
+	rings.ringEnds.push_back(rings.xyz.size() / 3);
 
-	double E_to[3][3];
+	foreach(DM::Face* hole, f->getHolePointers())
+	{
+		foreach(DM::Node* n, hole->getNodePointers()) {
+			n->get(v);
+			rings.original.insert(rings.original.end(), v, v + 3);
+			rings.xyz.resize(rings.xyz.size() + 3);
+			rings.projection.toPlane(v, &rings.xyz[rings.xyz.size() - 3]);
+		}
+		rings.ringEnds.push_back(rings.xyz.size() / 3);
+	}
+}
 
-	TBVectorData::CorrdinateSystem( *(nodeList[0]), *(nodeList[1]), *(nodeList[nodeList.size()-1]), E_to);
+bool CGALTriangulation::ConvexTriangulation(const FaceRings &rings, DM::IndexedMesh &mesh)
+{
+	if (rings.ringEnds.size() != 1)
+		return false;
 
-	double alphas[3][3];
-	TBVectorData::RotationMatrix(E, E_to, alphas);
+	//Skip repeated and closing nodes
+	unsigned int size_n = rings.ringEnds[0];
+	std::vector<unsigned int> ids;
+	std::vector<Point> points;
+	ids.reserve(size_n);
+	points.reserve(size_n);
+	for (unsigned int i = 0; i < size_n; i++) {
+		Point p(rings.xyz[3*i], rings.xyz[3*i+1]);
+		if (!points.empty() && (p == points.back() || (i == size_n - 1 && p == points.front())))
+			continue;
+		ids.push_back(i);
+		points.push_back(p);
+	}
+	int size_p = points.size();
+	if (size_p < 3)
+		return false;
 
-	double alphas_t[3][3];
-	for (int i = 0; i < 3; i++){
-		for (int j = 0; j < 3; j++){
-			alphas_t[j][i] =  alphas[i][j];
-		}
+	if (!CGAL::is_convex_2(points.begin(), points.end(), K()))
+		return false;
+	//Collinear nodes would create triangles without area
+	for (int i = 0; i < size_p; i++) {
+		if (CGAL::collinear(points[i], points[(i+1) % size_p], points[(i+2) % size_p]))
+			return false;
 	}
+	bool ccw = CGAL::orientation(points[0], points[1], points[2]) == CGAL::COUNTERCLOCKWISE;
 
-	DM::System transformedSys;
-	DM::SpatialNodeHashMap transfromedSysSNH(&transformedSys,100,false);
-	std::vector<DM::Node*> ns_t;
-	for (unsigned int i = 0; i < nodeList.size(); i++) {
-		DM::Node n = *(nodeList[i]);
-		DM::Node n_t =  TBVectorData::RotateVector(alphas, n);
-		transfromedSysSNH.addNode(n_t.getX(), n_t.getY(), n_t.getZ(), 0.0001);
-		ns_t.push_back( transfromedSysSNH.addNode(n_t.getX(), n_t.getY(), n_t.getZ(), 0.0001));
+	unsigned int first = mesh.numberOfVertices();
+	for (int i = 0; i < size_p; i++) {
+		const double * v = &rings.original[3*ids[i]];
+		mesh.addVertex(v[0], v[1], v[2]);
+	}
+	for (int i = 1; i < size_p - 1; i++) {
+		if (ccw)
+			mesh.addTriangle(first, first + i, first + i + 1);
+		else
+			mesh.addTriangle(first, first + i + 1, first + i);
 	}
+	return true;
+}
 
-	DM::Face * f_t = transformedSys.addFace(ns_t);
+bool CGALTriangulation::Triangulation(CDT &cdt, const FaceRings &rings, DM::IndexedMesh &mesh)
+{
+	if (ConvexTriangulation(rings, mesh))
+		return true;
 
-	CDT cdt;
-	Polygon_2 polygon1;
-	foreach(DM::Node* n, f_t->getNodePointers())
-		polygon1.push_back(Point(n->getX(),n->getY()));
+	cdt.clear();
 
 	//Insert the polyons into a constrained triangulation
-	insert_polygon(cdt,polygon1);
-
-	foreach(DM::Face* hole, f->getHolePointers())
-	{
-		std::vector<DM::Node* > nodes_h;
-		foreach(DM::Node* n, hole->getNodePointers())
-		{
-			DM::Node n_t = TBVectorData::RotateVector(alphas, *n);
-			nodes_h.push_back(transfromedSysSNH.addNode(n_t.getX(), n_t.getY(), n_t.getZ(), 0.0001));
-		}
-		Polygon_2 hole_p;
-		for (unsigned int  i = 0; i <nodes_h.size(); i++ ) {
-			DM::Node * n = nodes_h[i];
-			hole_p.push_back(Point(n->getX(),n->getY()));
-		}
-		insert_polygon(cdt,hole_p);
+	int numberOfNodes = 0;
+	unsigned int start = 0;
+	for (unsigned int i = 0; i < rings.ringEnds.size(); i++) {
+		numberOfNodes = insert_polygon(cdt, &rings.xyz[3*start], rings.ringEnds[i] - start, numberOfNodes);
+		start = rings.ringEnds[i];
 	}
 
 	//Mark facets that are inside the domain bounded by the polygon
 	mark_domains(cdt);
 
-	int count=0;
+	//Every CDT vertex is transformed back and written once
+	unsigned int vertices_before = mesh.vertices.size();
+	unsigned int triangles_before = mesh.triangles.size();
+	std::vector<int> vertexIds(numberOfNodes, -1);
+
 	for (CDT::Finite_faces_iterator fit=cdt.finite_faces_begin();
 		 fit!=cdt.finite_faces_end();++fit)
 	{
-		if ( fit->info().in_domain() ) ++count;
-		if (fit->info().in_domain() ) {
-			for (int i = 0; i < 3; i++) {
-				DM::Node * n_t = transfromedSysSNH.findNode(fit->vertex(i)->point().x(),  fit->vertex(i)->point().y(), 0.0001);
-				if (!n_t) {
-					DM::Logger(DM::Warning) << "Transformend Node doesn't exist triangulation failed";
-					return  triangles.clear();
+		if (!fit->info().in_domain() )
+			continue;
+		unsigned int ids[3];
+		for (int i = 0; i < 3; i++) {
+			CDT::Vertex_handle vh = fit->vertex(i);
+			int index = vh->info().index;
+			if (index == -1) {
+				mesh.vertices.resize(vertices_before);
+				mesh.triangles.resize(triangles_before);
+				return false;
+			}
+			if (vertexIds[index] == -1) {
+				double p_t[3] = {vh->point().x(), vh->point().y(), vh->info().z};
+				double p[3];
+				rings.projection.fromPlane(p_t, p);
+				vertexIds[index] = mesh.addVertex(p[0], p[1], p[2]);
+			}
+			ids[i] = vertexIds[index];
+		}
+		mesh.addTriangle(ids[0], ids[1], ids[2]);
+	}
+	return true;
+}
+
+void CGALTriangulation::Triangulation(DM::System *sys, DM::Face *f, std::vector<DM::Node> & triangles)
+{
+	DM::IndexedMesh mesh;
+	if (!CGALTriangulation::Triangulation(sys, f, mesh)) {
+		triangles.clear();
+		return;
+	}
+	mesh.toTriangleNodes(triangles);
+}
+
+bool CGALTriangulation::Triangulation(DM::System *sys, DM::Face *f, DM::IndexedMesh & mesh)
+{
+	FaceRings rings;
+	PrepareFace(sys, f, rings);
+
+	CDT cdt;
+	if (!Triangulation(cdt, rings, mesh)) {
+		DM::Logger(DM::Warning) << "Transformend Node doesn't exist triangulation failed";
+		return false;
+	}
+	return true;
+}
+
+void CGALTriangulation::TriangulateView(DM::System *sys, DM::View &view, DM::IndexedMesh &mesh, std::vector<unsigned int> &faceTriangleOffsets)
+{
+	const std::vector<DM::Component*> & faces = sys->getAllComponentsInView(view);
+
+	//Faces are read from the system before the parallel part starts
+	int size_f = faces.size();
+	std::vector<FaceRings> rings(size_f);
+	for (int i = 0; i < size_f; i++)
+		PrepareFace(sys, static_cast<DM::Face*>(faces[i]), rings[i]);
+
+	//Every thread reuses its own triangulation
+	std::vector<DM::IndexedMesh> parts(size_f);
+	std::vector<char> failed(size_f, 0);
+	#pragma omp parallel
+	{
+		CDT cdt;
+		#pragma omp for schedule(dynamic, 16)
+		for (int i = 0; i < size_f; i++)
+			failed[i] = !Triangulation(cdt, rings[i], parts[i]);
+	}
+
+	//Offsets of every face in the shared mesh
+	std::vector<unsigned int> vertexOffsets(size_f + 1, 0);
+	faceTriangleOffsets.assign(size_f + 1, 0);
+	int numberOfFailed = 0;
+	for (int i = 0; i < size_f; i++) {
+		vertexOffsets[i+1] = vertexOffsets[i] + parts[i].numberOfVertices();
+		faceTriangleOffsets[i+1] = faceTriangleOffsets[i] + parts[i].numberOfTriangles();
+		numberOfFailed += failed[i];
+	}
+
+	mesh.vertices.resize(3 * vertexOffsets[size_f]);
+	mesh.triangles.resize(3 * faceTriangleOffsets[size_f]);
+
+	#pragma omp parallel for schedule(dynamic, 16)
+	for (int i = 0; i < size_f; i++) {
+		const DM::IndexedMesh & part = parts[i];
+		std::copy(part.vertices.begin(), part.vertices.end(), mesh.vertices.begin() + 3 * vertexOffsets[i]);
+		unsigned int t = 3 * faceTriangleOffsets[i];
+		for (unsigned int j = 0; j < part.triangles.size(); j++)
+			mesh.triangles[t + j] = part.triangles[j] + vertexOffsets[i];
+	}
+
+	if (numberOfFailed > 0)
+		DM::Logger(DM::Warning) << "Triangulation failed for " << numberOfFailed << " faces";
+}
+
+int CGALTriangulation::mark_regions(CDT &cdt, std::vector<CDT::Face_handle> &representatives)
+{
+	for(CDT::All_faces_iterator it = cdt.all_faces_begin(); it != cdt.all_faces_end(); ++it){
+		it->info().nesting_level = -1;
+	}
+
+	representatives.clear();
+	std::list<CDT::Face_handle> queue;
+	CDT::All_faces_iterator next = cdt.all_faces_begin();
+	CDT::Face_handle start = cdt.infinite_face();
+	while (true) {
+		int region = representatives.size();
+		representatives.push_back(start);
+		start->info().nesting_level = region;
+		queue.push_back(start);
+		while(! queue.empty()){
+			CDT::Face_handle fh = queue.front();
+			queue.pop_front();
+			for(int i = 0; i < 3; i++){
+				CDT::Face_handle n = fh->neighbor(i);
+				if(n->info().nesting_level == -1 && !cdt.is_constrained(CDT::Edge(fh,i))) {
+					n->info().nesting_level = region;
+					queue.push_back(n);
 				}
+			}
+		}
+		while (next != cdt.all_faces_end() && next->info().nesting_level != -1)
+			++next;
+		if (next == cdt.all_faces_end())
+			break;
+		start = next;
+	}
+	return representatives.size();
+}
+
+void CGALTriangulation::TriangulateViewConforming(DM::System *sys, DM::View &view, DM::IndexedMesh &mesh, std::vector<int> &triangleFace)
+{
+	const std::vector<DM::Component*> & faces = sys->getAllComponentsInView(view);
+
+	mesh.clear();
+	triangleFace.clear();
 
-				triangles.push_back( TBVectorData::RotateVector(alphas_t, DM::Node( fit->vertex(i)->point().x(),  fit->vertex(i)->point().y(), n_t->getZ())));
+	//Shared nodes end up in the same vertex
+	CDT cdt;
+	std::vector<double> xyz;
+	double v[3];
+	int numberOfNodes = 0;
+	foreach(DM::Component * c, faces) {
+		DM::Face * f = static_cast<DM::Face*>(c);
+		xyz.clear();
+		foreach(DM::Node* n, TBVectorData::getNodeListFromFace(sys, f)) {
+			n->get(v);
+			xyz.insert(xyz.end(), v, v + 3);
+		}
+		if (!xyz.empty())
+			numberOfNodes = insert_polygon(cdt, &xyz[0], xyz.size() / 3, numberOfNodes);
+		foreach(DM::Face* hole, f->getHolePointers()) {
+			xyz.clear();
+			foreach(DM::Node* n, hole->getNodePointers()) {
+				n->get(v);
+				xyz.insert(xyz.end(), v, v + 3);
 			}
+			if (!xyz.empty())
+				numberOfNodes = insert_polygon(cdt, &xyz[0], xyz.size() / 3, numberOfNodes);
 		}
 	}
 
+	//Empty, single point or collinear input has no triangles
+	if (cdt.dimension() < 2)
+		return;
+
+	//Vertices at intersecting constraints get the mean z of their neighbours
+	for (CDT::Finite_vertices_iterator vit = cdt.finite_vertices_begin(); vit != cdt.finite_vertices_end(); ++vit) {
+		if (vit->info().index != -1)
+			continue;
+		double z = 0;
+		int count = 0;
+		CDT::Vertex_circulator vc = cdt.incident_vertices(vit), done(vc);
+		do {
+			if (!cdt.is_infinite(vc) && vc->info().index != -1) {
+				z += vc->info().z;
+				count++;
+			}
+		} while (++vc != done);
+		vit->info().z = count > 0 ? z / count : 0;
+	}
+
+	//One triangle per region is used to find the face of the region
+	std::vector<CDT::Face_handle> representatives;
+	int regions = mark_regions(cdt, representatives);
+	std::vector<double> centroids(2 * regions, 0);
+	for (int i = 1; i < regions; i++) {
+		CDT::Face_handle fh = representatives[i];
+		for (int j = 0; j < 3; j++) {
+			centroids[2*i] += fh->vertex(j)->point().x() / 3.;
+			centroids[2*i+1] += fh->vertex(j)->point().y() / 3.;
+		}
+	}
+	std::vector<int> regionFace = DM::CGALGeometry::PointsInFaces(centroids, faces);
+	//Region 0 is unbounded
+	regionFace[0] = -1;
+
+	//Vertex ids are assigned when a vertex is used the first time
+	for (CDT::Finite_vertices_iterator vit = cdt.finite_vertices_begin(); vit != cdt.finite_vertices_end(); ++vit)
+		vit->info().index = -1;
+
+	for (CDT::Finite_faces_iterator fit=cdt.finite_faces_begin();
+		 fit!=cdt.finite_faces_end();++fit)
+	{
+		int face = regionFace[fit->info().nesting_level];
+		if (face == -1)
+			continue;
+		unsigned int ids[3];
+		for (int i = 0; i < 3; i++) {
+			CDT::Vertex_handle vh = fit->vertex(i);
+			if (vh->info().index == -1)
+				vh->info().index = mesh.addVertex(vh->point().x(), vh->point().y(), vh->info().z);
+			ids[i] = vh->info().index;
+		}
+		mesh.addTriangle(ids[0], ids[1], ids[2]);
+		triangleFace.push_back(face);
+	}
 }
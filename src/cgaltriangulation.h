@@ -31,10 +31,13 @@
 #include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
 #include <CGAL/Constrained_Delaunay_triangulation_2.h>
 #include <CGAL/Triangulation_face_base_with_info_2.h>
+#include <CGAL/Triangulation_vertex_base_with_info_2.h>
 #include <CGAL/Polygon_2.h>
 #include <iostream>
 
 #include <dm.h>
+#include <indexedmesh.h>
+#include <planeprojection.h>
 
 struct FaceInfo2
 {
@@ -46,9 +49,18 @@ struct FaceInfo2
 	}
 };
 
+/** @brief z in the rotated plane and index of the input node, -1 for vertices
+ * created by the triangulation (e.g. at intersecting constraints)
+ */
+struct VertexInfo2
+{
+	VertexInfo2() : z(0), index(-1) {}
+	double z;
+	int index;
+};
 
 typedef CGAL::Exact_predicates_inexact_constructions_kernel       K;
-typedef CGAL::Triangulation_vertex_base_2<K>                      Vb;
+typedef CGAL::Triangulation_vertex_base_with_info_2<VertexInfo2,K> Vb;
 typedef CGAL::Triangulation_face_base_with_info_2<FaceInfo2,K>    Fbb;
 typedef CGAL::Constrained_triangulation_face_base_2<K,Fbb>        Fb;
 typedef CGAL::Triangulation_data_structure_2<Vb,Fb>               TDS;
@@ -57,12 +69,62 @@ typedef CGAL::Constrained_Delaunay_triangulation_2<K, TDS, Itag>  CDT;
 typedef CDT::Point                                                Point;
 typedef CGAL::Polygon_2<K>                                        Polygon_2;
 
+/** @brief Outer ring and holes of a face rotated into the x-y plane, nodes are stored as x,y,z.
+ * ringEnds holds the end of every ring, the first ring is the outer boundary.
+ * original holds the not rotated coordinates of the nodes.
+ */
+struct FaceRings
+{
+	DM::PlaneProjection projection;
+	std::vector<double> xyz;
+	std::vector<double> original;
+	std::vector<unsigned int> ringEnds;
+};
+
 class DM_HELPER_DLL_EXPORT CGALTriangulation
 {
 public:
 	static void mark_domains(CDT& ct,  CDT::Face_handle start, int index, std::list<CDT::Edge>& border );
 	static void mark_domains(CDT& cdt);
 	static void Triangulation(DM::System * sys, DM::Face * f, std::vector<DM::Node> & triangels);
+
+	/** @brief Appends the triangulation of the face to the mesh, vertices are shared between triangles.
+	 * Returns false if the triangulation failed, the mesh is left unchanged in this case.
+	 */
+	static bool Triangulation(DM::System * sys, DM::Face * f, DM::IndexedMesh & mesh);
+
+	/** @brief Reads the face from the system and rotates it into the plane */
+	static void PrepareFace(DM::System * sys, DM::Face * f, FaceRings & rings);
+
+	/** @brief Triangulates prepared rings, cdt is cleared and used as workspace.
+	 * Convex faces without holes are triangulated as fan without the cdt.
+	 * Does not access the system and can be called from several threads with one cdt per thread.
+	 */
+	static bool Triangulation(CDT & cdt, const FaceRings & rings, DM::IndexedMesh & mesh);
+
+	/** @brief Triangulates all faces of the view in parallel into mesh, existing content is replaced.
+	 * The triangles of face i are [faceTriangleOffsets[i], faceTriangleOffsets[i+1]).
+	 * Faces that can't be triangulated have an empty range.
+	 */
+	static void TriangulateView(DM::System * sys, DM::View & view, DM::IndexedMesh & mesh, std::vector<unsigned int> & faceTriangleOffsets);
+
+	/** @brief Inserts all faces of the view as constraints into one triangulation in the x-y plane.
+	 * Regions bounded by constraints are flooded and assigned to the face that contains them,
+	 * the lowest index if faces overlap. Triangles outside of all faces are dropped.
+	 * triangleFace holds the face index of every triangle, the content of mesh is replaced.
+	 */
+	static void TriangulateViewConforming(DM::System * sys, DM::View & view, DM::IndexedMesh & mesh, std::vector<int> & triangleFace);
+
+	/** @brief Sets nesting_level of every face to the id of its region, regions are sets of faces
+	 * connected by non constrained edges. Region 0 contains the infinite face. Returns the number of regions.
+	 */
+	static int mark_regions(CDT & cdt, std::vector<CDT::Face_handle> & representatives);
+
+	/** @brief Fan triangulation of a convex face without holes, returns false if the
+	 * face has holes, is not strictly convex or is degenerated. Triangles are counter
+	 * clockwise in the plane, same as the triangles of the cdt.
+	 */
+	static bool ConvexTriangulation(const FaceRings & rings, DM::IndexedMesh & mesh);
 };
 
 #endif // CGAL_TRIANGULATION_H
@@ -0,0 +1,105 @@
+/**
+ * @file
+ * @author  Christian Urich <christian.urich@gmail.com>
+ * @version 1.0
+ * @section LICENSE
+ *
+ * This file is part of DynaMind
+ *
+ * Copyright (C) 2013  Christian Urich
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "geometryhash.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace DM {
+
+GeometryHash::GeometryHash() :
+	hash(14695981039346656037ULL)
+{
+}
+
+void GeometryHash::addBytes(const unsigned char *bytes, unsigned int n)
+{
+	for (unsigned int i = 0; i < n; i++) {
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
+}
+
+void GeometryHash::add(double value)
+{
+	//-0 and 0 have to end up with the same hash
+	if (value == 0)
+		value = 0;
+	unsigned char bytes[sizeof(double)];
+	std::memcpy(bytes, &value, sizeof(double));
+	addBytes(bytes, sizeof(double));
+}
+
+void GeometryHash::add(int value)
+{
+	unsigned char bytes[sizeof(int)];
+	std::memcpy(bytes, &value, sizeof(int));
+	addBytes(bytes, sizeof(int));
+}
+
+void GeometryHash::add(const std::vector<double> &values)
+{
+	add((int) values.size());
+	for (unsigned int i = 0; i < values.size(); i++)
+		add(values[i]);
+}
+
+boost::uint64_t GeometryHash::value() const
+{
+	return hash;
+}
+
+void GeometryHash::CanonicalRing(std::vector<double> &xy)
+{
+	int size_n = xy.size() / 2;
+	xy.resize(2 * size_n);
+	while (size_n > 1 && xy[0] == xy[2*size_n-2] && xy[1] == xy[2*size_n-1])
+		size_n--;
+	xy.resize(2 * size_n);
+	if (size_n < 3)
+		return;
+
+	double area = 0;
+	int m = 0;
+	for (int i = 0; i < size_n; i++) {
+		int j = (i+1) % size_n;
+		area += (xy[2*i] - xy[0]) * (xy[2*j+1] - xy[1]) - (xy[2*j] - xy[0]) * (xy[2*i+1] - xy[1]);
+		if (xy[2*i+1] < xy[2*m+1] || (xy[2*i+1] == xy[2*m+1] && xy[2*i] < xy[2*m]))
+			m = i;
+	}
+
+	std::vector<double> canonical;
+	canonical.reserve(2 * size_n);
+	for (int i = 0; i < size_n; i++) {
+		int j = (area < 0) ? (m - i + size_n) % size_n : (m + i) % size_n;
+		canonical.push_back(xy[2*j]);
+		canonical.push_back(xy[2*j+1]);
+	}
+	xy.swap(canonical);
+}
+
+}
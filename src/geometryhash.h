@@ -0,0 +1,61 @@
+/**
+ * @file
+ * @author  Christian Urich <christian.urich@gmail.com>
+ * @version 1.0
+ * @section LICENSE
+ *
+ * This file is part of DynaMind
+ *
+ * Copyright (C) 2013  Christian Urich
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef GEOMETRYHASH_H
+#define GEOMETRYHASH_H
+
+#include <dm.h>
+#include <vector>
+#include <boost/cstdint.hpp>
+
+namespace DM {
+
+/** @brief 64 bit FNV-1a hash over coordinates, used as key for geometry caches */
+class DM_HELPER_DLL_EXPORT GeometryHash
+{
+public:
+	GeometryHash();
+
+	void add(double value);
+	void add(int value);
+	void add(const std::vector<double> & values);
+
+	boost::uint64_t value() const;
+
+	/** @brief Brings a ring of x,y coordinates into a canonical form: the closing
+	 * coordinate is removed, the ring is counter clockwise and starts at the
+	 * lowest-leftmost vertex. Equal polygons end up with equal coordinates.
+	 */
+	static void CanonicalRing(std::vector<double> & xy);
+
+private:
+	void addBytes(const unsigned char * bytes, unsigned int n);
+
+	boost::uint64_t hash;
+};
+}
+
+#endif // GEOMETRYHASH_H
@@ -0,0 +1,69 @@
+/**
+ * @file
+ * @author  Christian Urich <christian.urich@gmail.com>
+ * @version 1.0
+ * @section LICENSE
+ *
+ * This file is part of DynaMind
+ *
+ * Copyright (C) 2013  Christian Urich
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef GEOMETRYLOGGER_H
+#define GEOMETRYLOGGER_H
+
+#include <dm.h>
+
+/** @brief Lowest level that is compiled into the library, messages below are removed by the compiler.
+ * Only builds with DEBUG defined (CMAKE_BUILD_TYPE=Debug) keep Debug messages.
+ */
+#ifndef DM_GEOMETRY_LOG_THRESHOLD
+#ifdef DEBUG
+#define DM_GEOMETRY_LOG_THRESHOLD DM::Debug
+#else
+#define DM_GEOMETRY_LOG_THRESHOLD DM::Standard
+#endif
+#endif
+
+namespace DM {
+
+/** @brief Additional runtime filter for DM_GEOMETRY_LOG, messages that pass are still filtered by
+ * the level of DM::Log::init. The default is Standard, call setLevel(DM::Debug) in a debug build
+ * to get the messages of the geometry loops.
+ */
+class DM_HELPER_DLL_EXPORT GeometryLog
+{
+public:
+	static void setLevel(LogLevel level);
+	static LogLevel getLevel();
+
+	static bool enabled(LogLevel level) {return level >= current;}
+
+private:
+	static LogLevel current;
+};
+}
+
+/** @brief Logger for hot loops, the level is checked before the logger is created and
+ * the arguments are formatted. Use like DM::Logger: DM_GEOMETRY_LOG(DM::Debug) << value;
+ */
+#define DM_GEOMETRY_LOG(level) \
+	if ((level) < DM_GEOMETRY_LOG_THRESHOLD || !DM::GeometryLog::enabled(level)) ; \
+	else DM::Logger(level)
+
+#endif // GEOMETRYLOGGER_H
@@ -0,0 +1,91 @@
+/**
+ * @file
+ * @author  Christian Urich <christian.urich@gmail.com>
+ * @version 1.0
+ * @section LICENSE
+ *
+ * This file is part of DynaMind
+ *
+ * Copyright (C) 2013  Christian Urich
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef INDEXEDMESH_H
+#define INDEXEDMESH_H
+
+#include <dm.h>
+#include <vector>
+
+namespace DM {
+
+/** @brief Triangle mesh with shared vertices
+ *
+ * vertices holds x,y,z per vertex, triangles 3 vertex indices per triangle.
+ */
+class IndexedMesh
+{
+public:
+	std::vector<double> vertices;
+	std::vector<unsigned int> triangles;
+
+	unsigned int addVertex(double x, double y, double z)
+	{
+		vertices.push_back(x);
+		vertices.push_back(y);
+		vertices.push_back(z);
+		return vertices.size() / 3 - 1;
+	}
+
+	void addTriangle(unsigned int v1, unsigned int v2, unsigned int v3)
+	{
+		triangles.push_back(v1);
+		triangles.push_back(v2);
+		triangles.push_back(v3);
+	}
+
+	unsigned int numberOfVertices() const {return vertices.size() / 3;}
+	unsigned int numberOfTriangles() const {return triangles.size() / 3;}
+
+	void clear()
+	{
+		vertices.clear();
+		triangles.clear();
+	}
+
+	/** @brief Appends the mesh m, the indices of m are shifted */
+	void append(const IndexedMesh & m)
+	{
+		unsigned int offset = numberOfVertices();
+		vertices.insert(vertices.end(), m.vertices.begin(), m.vertices.end());
+		triangles.reserve(triangles.size() + m.triangles.size());
+		for (unsigned int i = 0; i < m.triangles.size(); i++)
+			triangles.push_back(m.triangles[i] + offset);
+	}
+
+	/** @brief Writes 3 nodes per triangle, the format used by CGALGeometry::FaceTriangulation */
+	void toTriangleNodes(std::vector<DM::Node> & nodes) const
+	{
+		nodes.reserve(nodes.size() + triangles.size());
+		for (unsigned int i = 0; i < triangles.size(); i++) {
+			unsigned int v = 3 * triangles[i];
+			nodes.push_back(DM::Node(vertices[v], vertices[v+1], vertices[v+2]));
+		}
+	}
+};
+}
+
+#endif // INDEXEDMESH_H
@@ -27,7 +27,10 @@
 #include "littlegeometryhelpers.h"
 #include "cgalgeometry.h"
 #include "tbvectordata.h"
+#include "planeprojection.h"
+#include "cgalskeletonisation.h"
 #include <algorithm>
+#include <map>
 #include <math.h>
 #include <QPointF>
 #include <QPolygonF>
@@ -38,40 +41,31 @@ std::vector<DM::Face*> LittleGeometryHelpers::CreateHolesInAWall(DM::System *sys
 {
 	std::vector<DM::Node*> nodes = f->getNodePointers();
 	//And again we rotate or wall again into x,y assuming. we assume that z is becoming our new x
-	double E[3][3];
-	TBVectorData::CorrdinateSystem( DM::Node(0,0,0), DM::Node(1,0,0), DM::Node(0,1,0), E);
-
-	double E_to[3][3];
-
-	TBVectorData::CorrdinateSystem( *(nodes[0]), *(nodes[1]), *(nodes[nodes.size()-1]), E_to);
-
+	//Walls are vertical, the window layout depends on the rotated frame so no axis shortcut is used
+	DM::PlaneProjection projection(nodes);
 
 	DM::Node dN1 = *(nodes[1]) - *(nodes[0]);
 	DM::Node dN2 = *(nodes[2]) - *(nodes[0]);
 	DM::Node orientationOriginal = TBVectorData::NormalVector(dN1, dN2);
 
-
-	double alphas[3][3];
-	TBVectorData::RotationMatrix(E, E_to, alphas);
-	
-	DM::Node n = TBVectorData::RotateVector(alphas, *(nodes[0]));
-	double x = n.getX();
-	double y = n.getY();
-	double z_const = n.getZ();
-	double xmin = x;
-	double xmax = x;
-	double ymin = y;
-	double ymax = y;
+	double v[3];
+	double v_t[3];
+	nodes[0]->get(v);
+	projection.toPlane(v, v_t);
+	double z_const = v_t[2];
+	double xmin = v_t[0];
+	double xmax = v_t[0];
+	double ymin = v_t[1];
+	double ymax = v_t[1];
 
 	for (unsigned int i = 1; i < nodes.size(); i++)
 	{
-		n = TBVectorData::RotateVector(alphas, *(nodes[i]));
-		x = n.getX();
-		y = n.getY();
-		xmin = min(xmin,x);
-		xmax = max(xmax,x);
-		ymin = min(ymin,y);
-		ymax = max(ymax,y);
+		nodes[i]->get(v);
+		projection.toPlane(v, v_t);
+		xmin = min(xmin,v_t[0]);
+		xmax = max(xmax,v_t[0]);
+		ymin = min(ymin,v_t[1]);
+		ymax = max(ymax,v_t[1]);
 	}
 
 	double l = ymax - ymin;
@@ -97,21 +91,17 @@ std::vector<DM::Face*> LittleGeometryHelpers::CreateHolesInAWall(DM::System *sys
 
 	}
 	//Transform Coordinates back
-	double alphas_t[3][3];
-	for (int i = 0; i < 3; i++){
-		for (int j = 0; j < 3; j++){
-			alphas_t[j][i] =  alphas[i][j];
-		}
-	}
-
-
 	std::vector<DM::Face * > windows;
 
 	for ( unsigned int i = 0; i < window_nodes.size()/4; i++){
 		std::vector<DM::Node*> window_nodes_t;
 		for (int j = 0; j < 4; j++) {
-			DM::Node n = TBVectorData::RotateVector(alphas_t, window_nodes[j+i*4]);
-			window_nodes_t.push_back(sys->addNode(n));
+			const DM::Node & n_t = window_nodes[j+i*4];
+			v_t[0] = n_t.getX();
+			v_t[1] = n_t.getY();
+			v_t[2] = n_t.getZ();
+			projection.fromPlane(v_t, v);
+			window_nodes_t.push_back(sys->addNode(v[0], v[1], v[2]));
 		}
 
 		DM::Node dN1_1 = *(window_nodes_t[1]) - *(window_nodes_t[0]);
@@ -201,6 +191,19 @@ void LittleGeometryHelpers::CreateStandardBuilding(DM::System * city, DM::View &
 
 }
 
+void addFace(DM::System* city, std::vector<DM::Node*> vf, std::string type, const std::vector<double> & color,
+			 DM::View & buildingView, DM::View &geometryView, DM::Component *BuildingInterface)
+{
+	if (vf.back() != vf.front())
+		vf.push_back(vf.front());
+
+	DM::Face * f =  city->addFace(vf, geometryView);
+	f->getAttribute("Parent")->addLink(BuildingInterface, buildingView.getName());
+	f->addAttribute("type", type);
+	f->getAttribute("color")->setDoubleVector(color);
+	BuildingInterface->getAttribute("Geometry")->addLink(f, "Geometry");
+}
+
 void addFace(DM::System* city, DM::Node* n1, DM::Node* n2, DM::Node* n3, DM::Node* n4, std::string type, std::vector<double> color,
 			 DM::View & buildingView, DM::View &geometryView, DM::Component *BuildingInterface)
 {
@@ -279,3 +282,159 @@ void LittleGeometryHelpers::CreateRoofRectangle(DM::System *city, DM::View & bui
 	addFace(city, n1, t1, n4, n1, "roof_wall", wallColor, buildingView, geometryView, BuildingInterface);
 	addFace(city, n2, n3, t2, n2, "roof_wall", wallColor, buildingView, geometryView, BuildingInterface);
 }
+
+namespace {
+
+/** Roof of one footprint, faces are open rings of vertex indices */
+struct RoofGeometry
+{
+	std::vector<double> vertices;
+	std::vector<std::vector<unsigned int> > faces;
+	std::vector<bool> walls;
+
+	unsigned int addVertex(double x, double y, double z)
+	{
+		vertices.push_back(x);
+		vertices.push_back(y);
+		vertices.push_back(z);
+		return vertices.size() / 3 - 1;
+	}
+
+	void addFace(unsigned int n1, unsigned int n2, unsigned int n3, unsigned int n4, bool wall)
+	{
+		std::vector<unsigned int> face;
+		face.push_back(n1);
+		face.push_back(n2);
+		face.push_back(n3);
+		if (n4 != n1)
+			face.push_back(n4);
+		faces.push_back(face);
+		walls.push_back(wall);
+	}
+};
+
+/** Gable roof over the minimal bounding box, the ridge runs along the long side */
+void gableRoof(const std::vector<double> & xy, double height, double alpha, RoofGeometry & roof)
+{
+	std::vector<double> c;
+	double l = -1;
+	double w = -1;
+	DM::CGALGeometry::MinBoundingBox(xy, c, l, w);
+	if (l < 0)
+		return;
+
+	//Start the corners with a long side
+	double d01 = (c[2]-c[0])*(c[2]-c[0]) + (c[3]-c[1])*(c[3]-c[1]);
+	double d12 = (c[4]-c[2])*(c[4]-c[2]) + (c[5]-c[3])*(c[5]-c[3]);
+	int s = d01 >= d12 ? 0 : 1;
+	double p[8];
+	unsigned int n[4];
+	for (int i = 0; i < 4; i++) {
+		p[2*i] = c[2*((i+s)%4)];
+		p[2*i+1] = c[2*((i+s)%4)+1];
+		n[i] = roof.addVertex(p[2*i], p[2*i+1], height);
+	}
+
+	const double pi =  3.14159265358979323846;
+	double ridge = height + tan(alpha / 180. * pi) * w / 2.;
+	unsigned int t1 = roof.addVertex((p[6] + p[0]) / 2., (p[7] + p[1]) / 2., ridge);
+	unsigned int t2 = roof.addVertex((p[2] + p[4]) / 2., (p[3] + p[5]) / 2., ridge);
+
+	roof.addFace(n[0], n[1], t2, t1, false);
+	roof.addFace(t1, t2, n[2], n[3], false);
+	roof.addFace(n[1], n[2], t2, n[1], true);
+	roof.addFace(n[3], n[0], t1, n[3], true);
+}
+
+/** Hip roof from the faces of the straight skeleton */
+void hipRoof(const std::vector<double> & xy, double height, double alpha, RoofGeometry & roof)
+{
+	std::vector<double> xyz;
+	std::vector<unsigned int> faceOffsets;
+	if (!DM::CGALSkeletonisation::RoofFaces(xy, height, alpha, xyz, faceOffsets))
+		return;
+
+	std::map<std::pair<double, double>, unsigned int> ids;
+	for (unsigned int i = 0; i + 1 < faceOffsets.size(); i++) {
+		std::vector<unsigned int> f;
+		for (unsigned int j = faceOffsets[i]; j < faceOffsets[i+1]; j++) {
+			std::pair<double, double> key(xyz[3*j], xyz[3*j+1]);
+			std::map<std::pair<double, double>, unsigned int>::const_iterator it = ids.find(key);
+			if (it == ids.end())
+				it = ids.insert(std::make_pair(key, roof.addVertex(xyz[3*j], xyz[3*j+1], xyz[3*j+2]))).first;
+			f.push_back(it->second);
+		}
+		roof.faces.push_back(f);
+		roof.walls.push_back(false);
+	}
+}
+}
+
+void LittleGeometryHelpers::CreateRoofs(DM::System *city, DM::View &footprintView, DM::View &geometryView, const std::vector<RoofType> &roofTypes, const std::vector<double> &heights, double alpha)
+{
+	std::vector<double> roofColor;
+	roofColor.push_back(178./255.);
+	roofColor.push_back(34./255.);
+	roofColor.push_back(34./255.);
+	std::vector<double> wallColor;
+	wallColor.push_back(196./255.);
+	wallColor.push_back(196./255.);
+	wallColor.push_back(196./255.);
+
+	std::vector<DM::Component*> footprints = city->getAllComponentsInView(footprintView);
+	int size_f = footprints.size();
+	if (roofTypes.size() < footprints.size() || heights.size() < footprints.size()) {
+		DM::Logger(DM::Warning) << "Roof type and height are needed for every footprint";
+		return;
+	}
+
+	//Read the footprints serial, offsets point to the first coordinate of every footprint
+	std::vector<double> xy;
+	std::vector<unsigned int> offsets(size_f + 1, 0);
+	double v[3];
+	for (int i = 0; i < size_f; i++) {
+		std::vector<DM::Node*> nodes = static_cast<DM::Face*>(footprints[i])->getNodePointers();
+		unsigned int s_nodes = nodes.size();
+		if (s_nodes > 0 && nodes[0] == nodes[s_nodes-1])
+			s_nodes--;
+		for (unsigned int j = 0; j < s_nodes; j++) {
+			nodes[j]->get(v);
+			xy.push_back(v[0]);
+			xy.push_back(v[1]);
+		}
+		offsets[i+1] = xy.size();
+	}
+
+	std::vector<RoofGeometry> roofs(size_f);
+	#pragma omp parallel for schedule(dynamic, 64)
+	for (int i = 0; i < size_f; i++) {
+		std::vector<double> footprint_xy(xy.begin() + offsets[i], xy.begin() + offsets[i+1]);
+		if (roofTypes[i] == GABLE_ROOF)
+			gableRoof(footprint_xy, heights[i], alpha, roofs[i]);
+		else
+			hipRoof(footprint_xy, heights[i], alpha, roofs[i]);
+	}
+
+	//Merge in the order of the footprints
+	int failed = 0;
+	for (int i = 0; i < size_f; i++) {
+		const RoofGeometry & roof = roofs[i];
+		if (roof.faces.empty()) {
+			failed++;
+			continue;
+		}
+		std::vector<DM::Node*> nodes;
+		nodes.reserve(roof.vertices.size() / 3);
+		for (unsigned int j = 0; j < roof.vertices.size(); j += 3)
+			nodes.push_back(city->addNode(roof.vertices[j], roof.vertices[j+1], roof.vertices[j+2]));
+		for (unsigned int j = 0; j < roof.faces.size(); j++) {
+			std::vector<DM::Node*> face;
+			foreach(unsigned int id, roof.faces[j])
+				face.push_back(nodes[id]);
+			addFace(city, face, roof.walls[j] ? "roof_wall" : "roof", roof.walls[j] ? wallColor : roofColor,
+					footprintView, geometryView, footprints[i]);
+		}
+	}
+	if (failed > 0)
+		DM::Logger(DM::Warning) << "No roof created for " << failed << " footprints";
+}
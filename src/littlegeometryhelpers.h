@@ -33,6 +33,11 @@
 class DM_HELPER_DLL_EXPORT LittleGeometryHelpers
 {
 public:
+	enum RoofType {
+		GABLE_ROOF,
+		HIP_ROOF
+	};
+
 	/** @brief creates holes in a wall */
 	static std::vector<DM::Face*>  CreateHolesInAWall(DM::System * sys, DM::Face * f, double distance, double width, double height, double parapet = 1.2);
 
@@ -41,6 +46,14 @@ public:
 
 	static void CreateRoofRectangle(DM::System * city, DM::View & buildingView,  DM::View & geometryView,  DM::Component * BuildingInterface, std::vector<DM::Node * >  & footprint, double heigh, double alpha);
 
+	/** @brief Creates the roofs for all footprints in footprintView. roofTypes and heights hold
+	 * one value per footprint in the order of the view, alpha is the roof slope in degree.
+	 * Gable roofs are built over the minimal bounding box, hip roofs from the straight skeleton.
+	 * The geometry is computed in parallel and added to city in one pass, the roof faces are
+	 * linked to their footprint like in CreateRoofRectangle.
+	 */
+	static void CreateRoofs(DM::System * city, DM::View & footprintView, DM::View & geometryView, const std::vector<RoofType> & roofTypes, const std::vector<double> & heights, double alpha);
+
 };
 
 #endif // CUTELITTLEGEOMETRYHELPERS_H
@@ -0,0 +1,148 @@
+/**
+ * @file
+ * @author  Christian Urich <christian.urich@gmail.com>
+ * @version 1.0
+ * @section LICENSE
+ *
+ * This file is part of DynaMind
+ *
+ * Copyright (C) 2013  Christian Urich
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef LRUCACHE_H
+#define LRUCACHE_H
+
+#include <list>
+#include <map>
+#include <cstddef>
+
+namespace DM {
+
+/** @brief Least recently used cache with a memory budget
+ *
+ * The size of every entry is provided by the caller. If the budget is
+ * exceeded the least recently used entries are removed. The cache is not
+ * thread safe, callers have to lock.
+ */
+template <class Key, class Value>
+class LruCache
+{
+public:
+	LruCache(std::size_t budget) :
+		budget(budget),
+		usage(0),
+		hitCounter(0),
+		missCounter(0)
+	{
+	}
+
+	/** @brief Returns true and sets value if key is in the cache */
+	bool get(const Key & key, Value & value)
+	{
+		typename Index::iterator it = index.find(key);
+		if (it == index.end()) {
+			missCounter++;
+			return false;
+		}
+		hitCounter++;
+		entries.splice(entries.begin(), entries, it->second);
+		value = it->second->value;
+		return true;
+	}
+
+	/** @brief Adds or replaces the entry for key */
+	void put(const Key & key, const Value & value, std::size_t size)
+	{
+		erase(key);
+		if (size > budget)
+			return;
+
+		Entry e;
+		e.key = key;
+		e.value = value;
+		e.size = size;
+		entries.push_front(e);
+		index[key] = entries.begin();
+		usage += size;
+		shrink();
+	}
+
+	void erase(const Key & key)
+	{
+		typename Index::iterator it = index.find(key);
+		if (it == index.end())
+			return;
+		usage -= it->second->size;
+		entries.erase(it->second);
+		index.erase(it);
+	}
+
+	void clear()
+	{
+		entries.clear();
+		index.clear();
+		usage = 0;
+	}
+
+	void resetCounters()
+	{
+		hitCounter = 0;
+		missCounter = 0;
+	}
+
+	void setBudget(std::size_t budget)
+	{
+		this->budget = budget;
+		shrink();
+	}
+
+	std::size_t getBudget() const {return budget;}
+	std::size_t getUsage() const {return usage;}
+	std::size_t size() const {return index.size();}
+	unsigned long hits() const {return hitCounter;}
+	unsigned long misses() const {return missCounter;}
+
+private:
+	struct Entry {
+		Key key;
+		Value value;
+		std::size_t size;
+	};
+	typedef std::list<Entry> Entries;
+	typedef std::map<Key, typename Entries::iterator> Index;
+
+	void shrink()
+	{
+		while (usage > budget && !entries.empty()) {
+			Entry & e = entries.back();
+			usage -= e.size;
+			index.erase(e.key);
+			entries.pop_back();
+		}
+	}
+
+	Entries entries;
+	Index index;
+	std::size_t budget;
+	std::size_t usage;
+	unsigned long hitCounter;
+	unsigned long missCounter;
+};
+}
+
+#endif // LRUCACHE_H
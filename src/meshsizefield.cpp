@@ -0,0 +1,123 @@
+/**
+ * @file
+ * @author  Christian Urich <christian.urich@gmail.com>
+ * @version 1.0
+ * @section LICENSE
+ *
+ * This file is part of DynaMind
+ *
+ * Copyright (C) 2013  Christian Urich
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "meshsizefield.h"
+
+#include <CGAL/Simple_cartesian.h>
+#include <CGAL/AABB_tree.h>
+#include <CGAL/AABB_traits.h>
+#include <CGAL/AABB_segment_primitive.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace DM {
+
+ConstantSizeField::ConstantSizeField(double meshsize) :
+	meshsize(meshsize)
+{
+}
+
+double ConstantSizeField::size(double, double) const
+{
+	return meshsize;
+}
+
+double ConstantSizeField::minimumSize() const
+{
+	return meshsize;
+}
+
+class EdgeDistanceSizeFieldPrivate
+{
+public:
+	typedef CGAL::Simple_cartesian<double>                     K;
+	typedef K::Point_3                                         Point_3;
+	typedef K::Segment_3                                       Segment_3;
+	typedef std::vector<Segment_3>::const_iterator             Iterator;
+	typedef CGAL::AABB_segment_primitive<K, Iterator>          Primitive;
+	typedef CGAL::AABB_traits<K, Primitive>                    Traits;
+	typedef CGAL::AABB_tree<Traits>                            Tree;
+
+	//The tree references the segments, both are created once and not changed afterwards
+	std::vector<Segment_3> segments;
+	Tree tree;
+};
+
+EdgeDistanceSizeField::EdgeDistanceSizeField(System *sys, View &edgeView, double minSize, double maxSize, double growth) :
+	d(new EdgeDistanceSizeFieldPrivate()),
+	minSize(minSize),
+	maxSize(maxSize),
+	growth(growth)
+{
+	typedef EdgeDistanceSizeFieldPrivate P;
+
+	//A minSize <= 0 is kept, the triangulation rejects the field by its minimumSize
+	if (minSize <= 0)
+		Logger(Warning) << "Minimum size has to be larger than 0";
+	if (maxSize < minSize) {
+		Logger(Warning) << "Maximum size is smaller than the minimum size, the minimum size is used";
+		this->maxSize = minSize;
+	}
+	if (growth < 0) {
+		Logger(Warning) << "Growth has to be positive, a growth of 0 is used";
+		this->growth = 0;
+	}
+
+	//Distances are 2D, the edges are flattened to z = 0
+	foreach(DM::Component * c, sys->getAllComponentsInView(edgeView)) {
+		DM::Edge * edge = static_cast<DM::Edge*>(c);
+		DM::Node * n1 = edge->getStartNode();
+		DM::Node * n2 = edge->getEndNode();
+		P::Segment_3 seg(P::Point_3(n1->getX(), n1->getY(), 0), P::Point_3(n2->getX(), n2->getY(), 0));
+		if (!seg.is_degenerate())
+			d->segments.push_back(seg);
+	}
+	if (d->segments.empty())
+		return;
+	d->tree.insert(d->segments.begin(), d->segments.end());
+	d->tree.build();
+	d->tree.accelerate_distance_queries();
+}
+
+double EdgeDistanceSizeField::size(double x, double y) const
+{
+	return std::min(maxSize, minSize + growth * distance(x, y));
+}
+
+double EdgeDistanceSizeField::minimumSize() const
+{
+	return minSize;
+}
+
+double EdgeDistanceSizeField::distance(double x, double y) const
+{
+	if (d->segments.empty())
+		return std::numeric_limits<double>::max();
+	return std::sqrt(d->tree.squared_distance(EdgeDistanceSizeFieldPrivate::Point_3(x, y, 0)));
+}
+
+}
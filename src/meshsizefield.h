@@ -0,0 +1,106 @@
+/**
+ * @file
+ * @author  Christian Urich <christian.urich@gmail.com>
+ * @version 1.0
+ * @section LICENSE
+ *
+ * This file is part of DynaMind
+ *
+ * Copyright (C) 2013  Christian Urich
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+
+#ifndef MESHSIZEFIELD_H
+#define MESHSIZEFIELD_H
+
+#include <dm.h>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+namespace DM {
+
+/** @brief Result of a graded triangulation. uniformTriangles estimates the triangles of a
+ * uniform mesh with the minimum size, as equilateral triangles it is a lower bound.
+ */
+struct MeshStatistics
+{
+	unsigned int triangles;
+	unsigned int uniformTriangles;
+	double area;
+};
+
+/** @brief Target edge length of a mesh as function of the location
+ *
+ * Used by CGALRegularTriangulation to grade the mesh. size() is called from
+ * the mesher for every triangle and has to be thread safe.
+ */
+class DM_HELPER_DLL_EXPORT MeshSizeField
+{
+public:
+	virtual ~MeshSizeField() {}
+
+	/** @brief Returns the maximal edge length at x, y */
+	virtual double size(double x, double y) const = 0;
+
+	/** @brief Returns the smallest size of the field, used to estimate the size of a uniform mesh.
+	 * Has to be larger than 0, smaller values returned by size() are raised to it.
+	 */
+	virtual double minimumSize() const = 0;
+};
+
+/** @brief Fixed size everywhere, same as the uniform regular triangulation */
+class DM_HELPER_DLL_EXPORT ConstantSizeField : public MeshSizeField
+{
+public:
+	ConstantSizeField(double meshsize);
+
+	double size(double x, double y) const;
+	double minimumSize() const;
+
+private:
+	double meshsize;
+};
+
+class EdgeDistanceSizeFieldPrivate;
+
+/** @brief Size grows with the 2D distance to a set of edges
+ *
+ * size = min(maxSize, minSize + growth * distance), e.g. fine elements along
+ * streets and inlets. Distances are queried from an AABB tree of the edges.
+ * minSize has to be larger than 0, maxSize >= minSize and growth >= 0.
+ */
+class DM_HELPER_DLL_EXPORT EdgeDistanceSizeField : public MeshSizeField
+{
+public:
+	EdgeDistanceSizeField(DM::System * sys, DM::View & edgeView, double minSize, double maxSize, double growth);
+
+	double size(double x, double y) const;
+	double minimumSize() const;
+
+	/** @brief Returns the 2D distance to the closest edge */
+	double distance(double x, double y) const;
+
+private:
+	boost::shared_ptr<EdgeDistanceSizeFieldPrivate> d;
+	double minSize;
+	double maxSize;
+	double growth;
+};
+}
+
+#endif // MESHSIZEFIELD_H
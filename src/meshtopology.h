@@ -0,0 +1,71 @@
+/**
+ * @file
+ * @author  Christian Urich <christian.urich@gmail.com>
+ * @version 1.0
+ * @section LICENSE
+ *
+ * This file is part of DynaMind
+ *
+ * Copyright (C) 2013  Christian Urich
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef MESHTOPOLOGY_H
+#define MESHTOPOLOGY_H
+
+#include <dm.h>
+#include <vector>
+
+namespace DM {
+
+/** @brief Adjacency of the triangles of an IndexedMesh in flat arrays
+ *
+ * Entry i of a triangle refers to the side opposite of its vertex i. neighbours holds
+ * the adjacent triangle per side (-1 on the boundary), triangleEdges the edge per side.
+ * edges holds the 2 vertex indices and edgeTriangles the 2 adjacent triangles per edge,
+ * the second triangle of a boundary edge is -1. Areas and centroids are per triangle.
+ */
+class MeshTopology
+{
+public:
+	std::vector<int> neighbours;
+	std::vector<unsigned int> triangleEdges;
+	std::vector<unsigned int> edges;
+	std::vector<int> edgeTriangles;
+	std::vector<char> boundary;
+	std::vector<double> areas;
+	std::vector<double> centroids;
+
+	unsigned int numberOfTriangles() const {return areas.size();}
+	unsigned int numberOfEdges() const {return boundary.size();}
+
+	bool isBoundary(unsigned int edge) const {return boundary[edge] != 0;}
+
+	void clear()
+	{
+		neighbours.clear();
+		triangleEdges.clear();
+		edges.clear();
+		edgeTriangles.clear();
+		boundary.clear();
+		areas.clear();
+		centroids.clear();
+	}
+};
+}
+
+#endif // MESHTOPOLOGY_H
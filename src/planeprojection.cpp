@@ -0,0 +1,156 @@
+/**
+ * @file
+ * @author  Christian Urich <christian.urich@gmail.com>
+ * @version 1.0
+ * @section LICENSE
+ *
+ * This file is part of DynaMind
+ *
+ * Copyright (C) 2013  Christian Urich
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "planeprojection.h"
+#include <tbvectordata.h>
+
+namespace DM {
+
+PlaneProjection::PlaneProjection() :
+	aligned(false)
+{
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			rotation[i][j] = (i == j) ? 1 : 0;
+			rotation_t[i][j] = rotation[i][j];
+		}
+	}
+}
+
+PlaneProjection::PlaneProjection(const std::vector<Node *> &nodes, bool axisAligned) :
+	aligned(false)
+{
+	init(nodes, *(nodes[nodes.size()-1]), axisAligned);
+}
+
+PlaneProjection::PlaneProjection(const std::vector<Node *> &nodes, const Node &n2, bool axisAligned) :
+	aligned(false)
+{
+	init(nodes, n2, axisAligned);
+}
+
+void PlaneProjection::init(const std::vector<Node *> &nodes, const Node &n2, bool axisAligned)
+{
+	if (axisAligned && alignToAxis(nodes))
+		return;
+
+	double E[3][3];
+	TBVectorData::CorrdinateSystem( DM::Node(0,0,0), DM::Node(1,0,0), DM::Node(0,1,0), E);
+
+	double E_to[3][3];
+	TBVectorData::CorrdinateSystem( *(nodes[0]), *(nodes[1]), n2, E_to);
+
+	double alphas[3][3];
+	TBVectorData::RotationMatrix(E, E_to, alphas);
+
+	//The rotation applied by TBVectorData::RotateVector is read back column by column
+	for (int j = 0; j < 3; j++) {
+		DM::Node e(j == 0 ? 1 : 0, j == 1 ? 1 : 0, j == 2 ? 1 : 0);
+		DM::Node r = TBVectorData::RotateVector(alphas, e);
+		rotation[0][j] = r.getX();
+		rotation[1][j] = r.getY();
+		rotation[2][j] = r.getZ();
+	}
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			rotation_t[j][i] = rotation[i][j];
+		}
+	}
+}
+
+bool PlaneProjection::alignToAxis(const std::vector<Node *> &nodes)
+{
+	double v0[3];
+	double v[3];
+	nodes[0]->get(v0);
+	int c = -1;
+	for (int a = 2; a >= 0 && c == -1; a--) {
+		bool constant = true;
+		for (unsigned int i = 1; i < nodes.size() && constant; i++) {
+			nodes[i]->get(v);
+			constant = (v[a] == v0[a]);
+		}
+		if (constant)
+			c = a;
+	}
+	if (c == -1)
+		return false;
+
+	//The cyclic permutation (c+1, c+2, c) is a rotation. y and z are flipped for
+	//clockwise rings so the ring is counter clockwise in the plane as with the rotation
+	int a = (c + 1) % 3;
+	int b = (c + 2) % 3;
+	double area = 0;
+	double v1[3];
+	for (unsigned int i = 0; i < nodes.size(); i++) {
+		nodes[i]->get(v);
+		nodes[(i+1) % nodes.size()]->get(v1);
+		area += (v[a] - v0[a]) * (v1[b] - v0[b]) - (v1[a] - v0[a]) * (v[b] - v0[b]);
+	}
+	double s = (area < 0) ? -1 : 1;
+
+	axis[0] = a;
+	axis[1] = b;
+	axis[2] = c;
+	sign[0] = 1;
+	sign[1] = s;
+	sign[2] = s;
+	aligned = true;
+	return true;
+}
+
+bool PlaneProjection::isAxisAligned() const
+{
+	return aligned;
+}
+
+void PlaneProjection::toPlane(const double *in, double *out) const
+{
+	double x = in[0], y = in[1], z = in[2];
+	if (aligned) {
+		double p[3] = {x, y, z};
+		for (int i = 0; i < 3; i++)
+			out[i] = sign[i] * p[axis[i]];
+		return;
+	}
+	for (int i = 0; i < 3; i++)
+		out[i] = rotation[i][0] * x + rotation[i][1] * y + rotation[i][2] * z;
+}
+
+void PlaneProjection::fromPlane(const double *in, double *out) const
+{
+	double x = in[0], y = in[1], z = in[2];
+	if (aligned) {
+		double p[3] = {x, y, z};
+		for (int i = 0; i < 3; i++)
+			out[axis[i]] = sign[i] * p[i];
+		return;
+	}
+	for (int i = 0; i < 3; i++)
+		out[i] = rotation_t[i][0] * x + rotation_t[i][1] * y + rotation_t[i][2] * z;
+}
+
+}
@@ -0,0 +1,82 @@
+/**
+ * @file
+ * @author  Christian Urich <christian.urich@gmail.com>
+ * @version 1.0
+ * @section LICENSE
+ *
+ * This file is part of DynaMind
+ *
+ * Copyright (C) 2013  Christian Urich
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+
+#ifndef PLANEPROJECTION_H
+#define PLANEPROJECTION_H
+
+#include <dm.h>
+#include <vector>
+
+namespace DM {
+
+/** @brief Rotation of a planar face into the x-y plane
+ *
+ * The plane is defined by three nodes of the face, by default the first, second
+ * and last node as used by the triangulation. The matrices are plain doubles,
+ * once created the projection can be used from several threads.
+ */
+class DM_HELPER_DLL_EXPORT PlaneProjection
+{
+public:
+	/** @brief Identity */
+	PlaneProjection();
+
+	/** @brief Plane defined by the first, second and last node.
+	 *
+	 * If axisAligned is set and all nodes lie in a plane normal to a coordinate axis
+	 * (e.g. footprints and flat roofs) no rotation is computed, the axes are only
+	 * permuted which is exact. The ring is counter clockwise in the plane, but the
+	 * frame within the plane is not the same as the one of the rotation.
+	 */
+	PlaneProjection(const std::vector<DM::Node*> & nodes, bool axisAligned = false);
+
+	/** @brief Plane defined by the first and second node and n2 */
+	PlaneProjection(const std::vector<DM::Node*> & nodes, const DM::Node & n2, bool axisAligned = false);
+
+	bool isAxisAligned() const;
+
+	/** @brief Rotates x,y,z into the plane */
+	void toPlane(const double * in, double * out) const;
+
+	/** @brief Rotates x,y,z from the plane back */
+	void fromPlane(const double * in, double * out) const;
+
+private:
+	void init(const std::vector<DM::Node*> & nodes, const DM::Node & n2, bool axisAligned);
+	bool alignToAxis(const std::vector<DM::Node*> & nodes);
+
+	double rotation[3][3];
+	double rotation_t[3][3];
+
+	//Axis aligned planes: out[i] = sign[i] * in[axis[i]]
+	bool aligned;
+	int axis[3];
+	double sign[3];
+};
+}
+
+#endif // PLANEPROJECTION_H
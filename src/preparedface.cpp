@@ -0,0 +1,198 @@
+/**
+ * @file
+ * @author  Christian Urich <christian.urich@gmail.com>
+ * @version 1.0
+ * @section LICENSE
+ *
+ * This file is part of DynaMind
+ *
+ * Copyright (C) 2013  Christian Urich
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "preparedface.h"
+
+#include <algorithm>
+#include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
+
+namespace DM {
+
+typedef CGAL::Exact_predicates_inexact_constructions_kernel   K_prepared;
+typedef K_prepared::Point_2                                   Point_prepared;
+
+PreparedFace::PreparedFace(Face *f) :
+	numberOfSlabs(0),
+	slabHeight(0),
+	xmin(0),
+	ymin(0),
+	xmax(0),
+	ymax(0)
+{
+	addRing(f, false);
+	foreach (DM::Face * h, f->getHolePointers())
+		addRing(h, true);
+
+	buildSlabs();
+}
+
+void PreparedFace::addRing(Face *f, bool hole)
+{
+	std::vector<DM::Node*> nodes = f->getNodePointers();
+	int size_n = nodes.size();
+	if (size_n < 3)
+		return;
+
+	double v1[3];
+	double v2[3];
+	for (int i = 0; i < size_n; i++) {
+		nodes[i]->get(v1);
+		nodes[(i+1) % size_n]->get(v2);
+
+		Edge e;
+		e.x1 = v1[0];
+		e.y1 = v1[1];
+		e.x2 = v2[0];
+		e.y2 = v2[1];
+		e.hole = hole;
+
+		if (edges.empty() && i == 0) {
+			xmin = xmax = e.x1;
+			ymin = ymax = e.y1;
+		}
+		xmin = std::min(xmin, e.x1);
+		xmax = std::max(xmax, e.x1);
+		ymin = std::min(ymin, e.y1);
+		ymax = std::max(ymax, e.y1);
+
+		edges.push_back(e);
+	}
+}
+
+unsigned int PreparedFace::slabIndex(double y) const
+{
+	if (slabHeight <= 0)
+		return 0;
+	double s = (y - ymin) / slabHeight;
+	if (s <= 0)
+		return 0;
+	if (s >= numberOfSlabs - 1)
+		return numberOfSlabs - 1;
+	return (unsigned int) s;
+}
+
+void PreparedFace::buildSlabs()
+{
+	if (edges.empty())
+		return;
+
+	//One slab per edge keeps the expected number of edges per slab constant
+	numberOfSlabs = edges.size();
+	slabHeight = (ymax - ymin) / numberOfSlabs;
+
+	unsigned int size_e = edges.size();
+
+	//Count, prefix sum and fill
+	std::vector<unsigned int> counter(numberOfSlabs + 1, 0);
+	for (unsigned int i = 0; i < size_e; i++) {
+		const Edge & e = edges[i];
+		unsigned int s1 = slabIndex(std::min(e.y1, e.y2));
+		unsigned int s2 = slabIndex(std::max(e.y1, e.y2));
+		for (unsigned int s = s1; s <= s2; s++)
+			counter[s+1]++;
+	}
+	for (unsigned int s = 0; s < numberOfSlabs; s++)
+		counter[s+1] += counter[s];
+
+	slabOffsets = counter;
+	slabEdges.resize(counter[numberOfSlabs]);
+	for (unsigned int i = 0; i < size_e; i++) {
+		const Edge & e = edges[i];
+		unsigned int s1 = slabIndex(std::min(e.y1, e.y2));
+		unsigned int s2 = slabIndex(std::max(e.y1, e.y2));
+		for (unsigned int s = s1; s <= s2; s++)
+			slabEdges[counter[s]++] = i;
+	}
+}
+
+bool PreparedFace::contains(double x, double y) const
+{
+	if (edges.empty())
+		return false;
+	if (x < xmin || x > xmax || y < ymin || y > ymax)
+		return false;
+
+	Point_prepared p(x, y);
+
+	unsigned int s = slabIndex(y);
+	bool inside = false;
+	for (unsigned int i = slabOffsets[s]; i < slabOffsets[s+1]; i++) {
+		const Edge & e = edges[slabEdges[i]];
+		Point_prepared a(e.x1, e.y1);
+		Point_prepared b(e.x2, e.y2);
+
+		CGAL::Orientation orient = CGAL::orientation(a, b, p);
+
+		//Points on the boundary
+		if (orient == CGAL::COLLINEAR &&
+				x >= std::min(e.x1, e.x2) && x <= std::max(e.x1, e.x2) &&
+				y >= std::min(e.y1, e.y2) && y <= std::max(e.y1, e.y2))
+			return !e.hole;
+
+		//Count crossings of the ray to +x
+		if ((e.y1 > y) != (e.y2 > y)) {
+			if (e.y2 > e.y1 && orient == CGAL::LEFT_TURN)
+				inside = !inside;
+			else if (e.y2 < e.y1 && orient == CGAL::RIGHT_TURN)
+				inside = !inside;
+		}
+	}
+	return inside;
+}
+
+bool PreparedFace::contains(const Node &n) const
+{
+	return contains(n.getX(), n.getY());
+}
+
+void PreparedFace::contains(const std::vector<double> &x, const std::vector<double> &y, std::vector<int> &inside) const
+{
+	unsigned int size_n = std::min(x.size(), y.size());
+	inside.resize(size_n);
+	for (unsigned int i = 0; i < size_n; i++)
+		inside[i] = contains(x[i], y[i]) ? 1 : 0;
+}
+
+void PreparedFace::contains(const double *xy, unsigned int n, int *inside) const
+{
+	for (unsigned int i = 0; i < n; i++)
+		inside[i] = contains(xy[2*i], xy[2*i+1]) ? 1 : 0;
+}
+
+void PreparedFace::getBoundingBox(double &xmin, double &ymin, double &xmax, double &ymax) const
+{
+	xmin = this->xmin;
+	ymin = this->ymin;
+	xmax = this->xmax;
+	ymax = this->ymax;
+}
+
+bool PreparedFace::isEmpty() const
+{
+	return edges.empty();
+}
+
+}
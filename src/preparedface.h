@@ -0,0 +1,93 @@
+/**
+ * @file
+ * @author  Christian Urich <christian.urich@gmail.com>
+ * @version 1.0
+ * @section LICENSE
+ *
+ * This file is part of DynaMind
+ *
+ * Copyright (C) 2013  Christian Urich
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef PREPAREDFACE_H
+#define PREPAREDFACE_H
+
+#include <dm.h>
+#include <vector>
+
+namespace DM {
+
+/** @brief Face prepared for repeated point in face queries
+ *
+ * The edges of the outer boundary and of all holes are stored in
+ * horizontal slabs. A query only tests the edges of the slab that contains
+ * the point, the holes are handled by the same even-odd crossing test.
+ * Same semantic as CGALGeometry::NodeWithinFace: the outer boundary is inside,
+ * the boundary of a hole is outside.
+ */
+class DM_HELPER_DLL_EXPORT PreparedFace
+{
+public:
+	PreparedFace(DM::Face * f);
+
+	/** @brief Returns true if the point is within the face */
+	bool contains(double x, double y) const;
+
+	/** @brief Returns true if the node is within the face, z is ignored */
+	bool contains(const DM::Node & n) const;
+
+	/** @brief Batch contains, inside[i] is set to 1 if (x[i], y[i]) is within the face */
+	void contains(const std::vector<double> & x, const std::vector<double> & y, std::vector<int> & inside) const;
+
+	/** @brief Batch contains over n interleaved x,y coordinates */
+	void contains(const double * xy, unsigned int n, int * inside) const;
+
+	/** @brief Returns the 2D bounding box as xmin, ymin, xmax, ymax */
+	void getBoundingBox(double & xmin, double & ymin, double & xmax, double & ymax) const;
+
+	bool isEmpty() const;
+
+private:
+	struct Edge {
+		double x1;
+		double y1;
+		double x2;
+		double y2;
+		bool hole;
+	};
+
+	void addRing(DM::Face * f, bool hole);
+	void buildSlabs();
+	unsigned int slabIndex(double y) const;
+
+	std::vector<Edge> edges;
+
+	//Edges per slab stored as offsets into slabEdges
+	std::vector<unsigned int> slabOffsets;
+	std::vector<unsigned int> slabEdges;
+	unsigned int numberOfSlabs;
+	double slabHeight;
+
+	double xmin;
+	double ymin;
+	double xmax;
+	double ymax;
+};
+}
+
+#endif // PREPAREDFACE_H
@@ -1,26 +1,26 @@
 #include "spatialsearchnearestnodes.h"
 
-#include <list>
 #include <cmath>
+#include <algorithm>
 #include <tbvectordata.h>
+#include <geometrylogger.h>
 #ifndef __clang__
 #include <omp.h>
 #endif
 
-SpatialSearchNearestNodes::SpatialSearchNearestNodes(DM::System * sys, std::vector<DM::Node*> nodes)
+SpatialSearchNearestNodes::SpatialSearchNearestNodes(DM::System *, std::vector<DM::Node*> nodes) :
+	nodes(nodes)
 {
+	std::vector<Point_and_node> points;
+	points.reserve(nodes.size());
 
-	sphm = new DM::SpatialNodeHashMap(sys, 1, false);
-
-	std::list<Point_d> points;
-
-	foreach (DM::Node * n, nodes) {
-		sphm->addNodeToSpatialNodeHashMap(n);
-		points.push_back(Point_d(n->getX(), n->getY()));
-	}
+	for (unsigned int i = 0; i < nodes.size(); i++)
+		points.push_back(boost::make_tuple(Point_d(nodes[i]->getX(), nodes[i]->getY()), (int) i));
 
+	//CGAL builds the tree lazily, building it here makes queries read only. An empty tree can't be built
 	searchTree = new Tree(points.begin(), points.end());
-
+	if (!points.empty())
+		searchTree->build();
 }
 
 SpatialSearchNearestNodes::~SpatialSearchNearestNodes()
@@ -31,26 +31,134 @@ SpatialSearchNearestNodes::~SpatialSearchNearestNodes()
 DM::Node *SpatialSearchNearestNodes::findNearestNode(DM::Node *n, double treshhold)
 {
 	const unsigned int N = 1;
+	if (nodes.empty())
+		return 0;
 
 	Point_d query(n->getX(),n->getY());
 	Neighbor_search search(*searchTree, query, N);
-	Point_d p;
 	for(Neighbor_search::iterator it = search.begin(); it != search.end(); ++it){
-		p = it->first;
 		double lenght =  std::sqrt(it->second);
-		DM::Logger(DM::Debug) <<lenght;
+		DM_GEOMETRY_LOG(DM::Debug) << lenght;
 		if (treshhold > 0 && treshhold < lenght )
 			return 0;
 
-		break;
+		const Point_d & p = boost::get<0>(it->first);
+		DM_GEOMETRY_LOG(DM::Debug) << p.x() << "\t" << p.y();
+		return nodes[boost::get<1>(it->first)];
 	}
 
-	DM::Logger(DM::Debug) << p.x() << "\t" << p.y();
+	return 0;
+}
 
-	return sphm->findNode(p.x(),  p.y(), 0.0001);
+void SpatialSearchNearestNodes::nearest(double x, double y, unsigned int k, double treshhold, std::vector<std::pair<double, int> > &result) const
+{
+	result.clear();
+	if (k == 0 || nodes.empty())
+		return;
+	Neighbor_search search(*searchTree, Point_d(x, y), k);
+	for(Neighbor_search::iterator it = search.begin(); it != search.end(); ++it){
+		if (treshhold > 0 && treshhold * treshhold < it->second)
+			break;
+		result.push_back(std::make_pair(it->second, boost::get<1>(it->first)));
+	}
 }
 
+void SpatialSearchNearestNodes::inRadius(double x, double y, double radius, std::vector<std::pair<double, int> > &result) const
+{
+	result.clear();
+	if (nodes.empty())
+		return;
+	std::vector<Point_and_node> found;
+	Sphere sphere(boost::make_tuple(Point_d(x, y), -1), radius);
+	searchTree->search(std::back_inserter(found), sphere);
+
+	//Points on the border can be reported by the fuzzy sphere, the distance is checked again
+	foreach (const Point_and_node & p, found) {
+		const Point_d & pt = boost::get<0>(p);
+		double d = (pt.x() - x) * (pt.x() - x) + (pt.y() - y) * (pt.y() - y);
+		if (d <= radius * radius)
+			result.push_back(std::make_pair(d, boost::get<1>(p)));
+	}
+	std::sort(result.begin(), result.end());
+}
 
+std::vector<DM::Node *> SpatialSearchNearestNodes::findNearestNodes(DM::Node *n, unsigned int k, double treshhold)
+{
+	std::vector<std::pair<double, int> > result;
+	nearest(n->getX(), n->getY(), k, treshhold, result);
+	std::vector<DM::Node *> found;
+	for (unsigned int i = 0; i < result.size(); i++)
+		found.push_back(nodes[result[i].second]);
+	return found;
+}
 
+std::vector<DM::Node *> SpatialSearchNearestNodes::findNodesInRadius(DM::Node *n, double radius)
+{
+	std::vector<std::pair<double, int> > result;
+	inRadius(n->getX(), n->getY(), radius, result);
+	std::vector<DM::Node *> found;
+	for (unsigned int i = 0; i < result.size(); i++)
+		found.push_back(nodes[result[i].second]);
+	return found;
+}
 
+void SpatialSearchNearestNodes::findNearestNodes(const std::vector<DM::Node *> &queries, unsigned int k, std::vector<int> &indices, std::vector<double> &distances, double treshhold)
+{
+	std::vector<double> xy;
+	xy.reserve(2 * queries.size());
+	foreach (DM::Node * n, queries) {
+		xy.push_back(n->getX());
+		xy.push_back(n->getY());
+	}
+	findNearestNodes(xy, k, indices, distances, treshhold);
+}
 
+void SpatialSearchNearestNodes::findNearestNodes(const std::vector<double> &xy, unsigned int k, std::vector<int> &indices, std::vector<double> &distances, double treshhold)
+{
+	int size_q = xy.size() / 2;
+	indices.assign(size_q * k, -1);
+	distances.assign(size_q * k, -1);
+
+	#pragma omp parallel
+	{
+		std::vector<std::pair<double, int> > result;
+		#pragma omp for schedule(dynamic, 256)
+		for (int i = 0; i < size_q; i++) {
+			nearest(xy[2*i], xy[2*i+1], k, treshhold, result);
+			for (unsigned int j = 0; j < result.size(); j++) {
+				indices[i*k + j] = result[j].second;
+				distances[i*k + j] = std::sqrt(result[j].first);
+			}
+		}
+	}
+}
+
+void SpatialSearchNearestNodes::findNodesInRadius(const std::vector<DM::Node *> &queries, double radius, std::vector<unsigned int> &offsets, std::vector<int> &indices, std::vector<double> &distances)
+{
+	int size_q = queries.size();
+	std::vector<double> xy;
+	xy.reserve(2 * size_q);
+	foreach (DM::Node * n, queries) {
+		xy.push_back(n->getX());
+		xy.push_back(n->getY());
+	}
+
+	//Results are collected per query and copied behind the prefix sums
+	std::vector<std::vector<std::pair<double, int> > > results(size_q);
+	#pragma omp parallel for schedule(dynamic, 256)
+	for (int i = 0; i < size_q; i++)
+		inRadius(xy[2*i], xy[2*i+1], radius, results[i]);
+
+	offsets.assign(size_q + 1, 0);
+	for (int i = 0; i < size_q; i++)
+		offsets[i+1] = offsets[i] + results[i].size();
+	indices.resize(offsets[size_q]);
+	distances.resize(offsets[size_q]);
+	#pragma omp parallel for schedule(static)
+	for (int i = 0; i < size_q; i++) {
+		for (unsigned int j = 0; j < results[i].size(); j++) {
+			indices[offsets[i] + j] = results[i][j].second;
+			distances[offsets[i] + j] = std::sqrt(results[i][j].first);
+		}
+	}
+}
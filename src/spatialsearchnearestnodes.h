@@ -5,31 +5,68 @@
 #include <dmgeometry.h>
 
 #include <CGAL/Simple_cartesian.h>
-#include <CGAL/point_generators_2.h>
 #include <CGAL/Orthogonal_k_neighbor_search.h>
 #include <CGAL/Search_traits_2.h>
+#include <CGAL/Search_traits_adapter.h>
+#include <CGAL/Fuzzy_sphere.h>
+#include <CGAL/property_map.h>
+#include <boost/tuple/tuple.hpp>
 
 
 
+/** @brief Nearest node search in x,y, the k-d tree stores the index of the node with the points.
+ *
+ * Indices returned by the batch queries refer to the nodes passed to the constructor, missing
+ * results are -1. Queries only read the tree and can run in parallel.
+ */
 class DM_HELPER_DLL_EXPORT SpatialSearchNearestNodes
 {
 	typedef CGAL::Simple_cartesian<double> K;
 	typedef K::Point_2 Point_d;
-	typedef CGAL::Search_traits_2<K> TreeTraits;
+	typedef boost::tuple<Point_d, int> Point_and_node;
+	typedef CGAL::Search_traits_2<K> Traits_base;
+	typedef CGAL::Search_traits_adapter<Point_and_node, CGAL::Nth_of_tuple_property_map<0, Point_and_node>, Traits_base> TreeTraits;
 	typedef CGAL::Orthogonal_k_neighbor_search<TreeTraits> Neighbor_search;
 	typedef Neighbor_search::Tree Tree;
+	typedef CGAL::Fuzzy_sphere<TreeTraits> Sphere;
 
 public:
+	/** @brief Builds the tree over nodes, sys is not used anymore */
 	SpatialSearchNearestNodes(DM::System * sys, std::vector<DM::Node *> nodes);
 	~SpatialSearchNearestNodes();
 
+	/** @brief Returns the nearest node or 0 if it is further away than treshhold (if treshhold > 0) */
 	DM::Node * findNearestNode(DM::Node * n, double treshhold = -1);
 
+	/** @brief Returns the k nearest nodes ordered by distance, nodes further away than treshhold (if treshhold > 0) are skipped */
+	std::vector<DM::Node *> findNearestNodes(DM::Node * n, unsigned int k, double treshhold = -1);
+
+	/** @brief Returns all nodes within radius ordered by distance */
+	std::vector<DM::Node *> findNodesInRadius(DM::Node * n, double radius);
+
+	/** @brief k nearest nodes for all queries in parallel. indices and distances hold k values per
+	 * query ordered by distance, missing results are -1.
+	 */
+	void findNearestNodes(const std::vector<DM::Node *> & queries, unsigned int k, std::vector<int> & indices, std::vector<double> & distances, double treshhold = -1);
+
+	/** @brief Same as above with the queries given as x,y coordinates */
+	void findNearestNodes(const std::vector<double> & xy, unsigned int k, std::vector<int> & indices, std::vector<double> & distances, double treshhold = -1);
+
+	/** @brief Nodes within radius for all queries in parallel. The results of query i are
+	 * indices[offsets[i]] to indices[offsets[i+1]-1], ordered by distance.
+	 */
+	void findNodesInRadius(const std::vector<DM::Node *> & queries, double radius, std::vector<unsigned int> & offsets, std::vector<int> & indices, std::vector<double> & distances);
+
 private:
-	Tree * searchTree;
-	std::list<Point_d> points;
+	SpatialSearchNearestNodes(const SpatialSearchNearestNodes &);
+	SpatialSearchNearestNodes & operator=(const SpatialSearchNearestNodes &);
 
-	DM::SpatialNodeHashMap * sphm;
+	/** Nearest k results as pairs of squared distance and index, ordered by distance */
+	void nearest(double x, double y, unsigned int k, double treshhold, std::vector<std::pair<double, int> > & result) const;
+	void inRadius(double x, double y, double radius, std::vector<std::pair<double, int> > & result) const;
+
+	Tree * searchTree;
+	std::vector<DM::Node *> nodes;
 };
 
 #endif // SPATIALSEARCHNEARESTNODES_H
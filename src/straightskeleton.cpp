@@ -0,0 +1,107 @@
+/**
+ * @file
+ * @author  Christian Urich <christian.urich@gmail.com>
+ * @version 1.0
+ * @section LICENSE
+ *
+ * This file is part of DynaMind
+ *
+ * Copyright (C) 2013  Christian Urich
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "straightskeleton.h"
+#include "straightskeletoncache.h"
+
+#include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
+#include <CGAL/Polygon_2.h>
+#include <CGAL/create_offset_polygons_2.h>
+
+namespace DM {
+
+class StraightSkeletonPrivate
+{
+public:
+	typedef CGAL::Exact_predicates_inexact_constructions_kernel K ;
+	typedef K::Point_2                                          Point_2;
+	typedef CGAL::Polygon_2<K>                                  Polygon_2;
+	typedef boost::shared_ptr<Polygon_2>                        PolygonPtr ;
+	typedef StraightSkeletonCache::SsPtr                        SsPtr ;
+	typedef std::vector<PolygonPtr>                             PolygonPtrVector ;
+
+	std::vector<DM::Node> original;
+	SsPtr ss;
+};
+
+StraightSkeleton::StraightSkeleton(const std::vector<Node *> &nodes) :
+	d(new StraightSkeletonPrivate())
+{
+	std::vector<double> xy;
+	xy.reserve(2 * nodes.size());
+	double v[3];
+	for (unsigned int i = 0; i < nodes.size(); i++) {
+		nodes[i]->get(v);
+		d->original.push_back(Node(v[0], v[1], 0));
+		xy.push_back(v[0]);
+		xy.push_back(v[1]);
+	}
+
+	d->ss = StraightSkeletonCache::InteriorStraightSkeleton(xy);
+	if (!d->ss)
+		Logger(Warning) << "Can't perform offset polygon is not simple";
+}
+
+bool StraightSkeleton::isValid() const
+{
+	return d->ss.get() != 0;
+}
+
+std::vector<std::vector<Node> > StraightSkeleton::offset(double distance) const
+{
+	std::vector<std::vector<DM::Node> > ret_points;
+
+	if (distance == 0) {
+		ret_points.push_back(d->original);
+		return ret_points;
+	}
+	if (!isValid())
+		return ret_points;
+
+	StraightSkeletonPrivate::PolygonPtrVector offset_polygons =
+			CGAL::create_offset_polygons_2<StraightSkeletonPrivate::Polygon_2>(distance, *(d->ss));
+
+	foreach(StraightSkeletonPrivate::PolygonPtr poly, offset_polygons) {
+		const StraightSkeletonPrivate::Polygon_2 & p = *(poly);
+		std::vector<DM::Node> dmpoly;
+		for (unsigned int i = 0; i < p.size(); i++ ) {
+			dmpoly.push_back(Node(p[i].x(), p[i].y(), 0));
+		}
+		ret_points.push_back(dmpoly);
+	}
+	return ret_points;
+}
+
+std::vector<std::vector<std::vector<Node> > > StraightSkeleton::offset(const std::vector<double> &distances) const
+{
+	std::vector<std::vector<std::vector<DM::Node> > > ret_offsets;
+	ret_offsets.reserve(distances.size());
+	for (unsigned int i = 0; i < distances.size(); i++)
+		ret_offsets.push_back(offset(distances[i]));
+	return ret_offsets;
+}
+
+}
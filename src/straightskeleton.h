@@ -0,0 +1,64 @@
+/**
+ * @file
+ * @author  Christian Urich <christian.urich@gmail.com>
+ * @version 1.0
+ * @section LICENSE
+ *
+ * This file is part of DynaMind
+ *
+ * Copyright (C) 2013  Christian Urich
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef STRAIGHTSKELETON_H
+#define STRAIGHTSKELETON_H
+
+#include <dm.h>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+namespace DM {
+
+class StraightSkeletonPrivate;
+
+/** @brief Interior straight skeleton of a polygon that can be reused for offsets
+ *
+ * Building the skeleton is the expensive part of an offset, once built
+ * offset polygons for any number of distances are cheap. Copies share the
+ * same skeleton.
+ */
+class DM_HELPER_DLL_EXPORT StraightSkeleton
+{
+public:
+	/** @brief Builds the skeleton of the polygon defined by the nodes, z is ignored */
+	StraightSkeleton(const std::vector<DM::Node*> & nodes);
+
+	/** @brief Returns false if the polygon is not simple and no skeleton could be created */
+	bool isValid() const;
+
+	/** @brief Returns the offset polygons for the distance, for 0 the original polygon is returned */
+	std::vector<std::vector<DM::Node> > offset(double distance) const;
+
+	/** @brief Returns the offset polygons for every distance */
+	std::vector<std::vector<std::vector<DM::Node> > > offset(const std::vector<double> & distances) const;
+
+private:
+	boost::shared_ptr<StraightSkeletonPrivate> d;
+};
+}
+
+#endif // STRAIGHTSKELETON_H
@@ -0,0 +1,137 @@
+/**
+ * @file
+ * @author  Christian Urich <christian.urich@gmail.com>
+ * @version 1.0
+ * @section LICENSE
+ *
+ * This file is part of DynaMind
+ *
+ * Copyright (C) 2013  Christian Urich
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "straightskeletoncache.h"
+#include "geometryhash.h"
+#include "lrucache.h"
+
+#include <boost/thread/mutex.hpp>
+#include <CGAL/Polygon_2.h>
+#include <CGAL/create_straight_skeleton_2.h>
+
+namespace DM {
+
+namespace {
+
+struct CachedSkeleton {
+	std::vector<double> ring;
+	StraightSkeletonCache::SsPtr ss;
+};
+
+typedef LruCache<boost::uint64_t, CachedSkeleton> SkeletonLruCache;
+
+boost::mutex skeletonCacheMutex;
+SkeletonLruCache skeletonCache(64 * 1024 * 1024);
+
+std::size_t estimateSize(const CachedSkeleton & c)
+{
+	typedef StraightSkeletonCache::Ss Ss;
+	//HalfedgeDS_list stores every item in a list node with two additional pointers
+	std::size_t size = sizeof(CachedSkeleton) + c.ring.size() * sizeof(double);
+	if (c.ss) {
+		size += sizeof(Ss);
+		size += c.ss->size_of_vertices() * (sizeof(Ss::Vertex) + 2 * sizeof(void*));
+		size += c.ss->size_of_halfedges() * (sizeof(Ss::Halfedge) + 2 * sizeof(void*));
+		size += c.ss->size_of_faces() * (sizeof(Ss::Face) + 2 * sizeof(void*));
+	}
+	return size;
+}
+}
+
+StraightSkeletonCache::SsPtr StraightSkeletonCache::InteriorStraightSkeleton(const std::vector<double> &xy)
+{
+	typedef K::Point_2                   Point_2;
+	typedef CGAL::Polygon_2<K>           Polygon_2;
+
+	CachedSkeleton c;
+	c.ring = xy;
+	GeometryHash::CanonicalRing(c.ring);
+
+	GeometryHash hash;
+	hash.add(c.ring);
+	boost::uint64_t key = hash.value();
+
+	{
+		boost::mutex::scoped_lock lock(skeletonCacheMutex);
+		CachedSkeleton cached;
+		//The ring is compared to rule out hash collisions
+		if (skeletonCache.get(key, cached) && cached.ring == c.ring)
+			return cached.ss;
+	}
+
+	//Build outside of the lock, concurrent misses do not block each other
+	Polygon_2 poly_s;
+	for (unsigned int i = 0; i < c.ring.size() / 2; i++)
+		poly_s.push_back(Point_2(c.ring[2*i], c.ring[2*i+1]));
+
+	if (poly_s.size() >= 3 && poly_s.is_simple())
+		c.ss = CGAL::create_interior_straight_skeleton_2(poly_s.vertices_begin(), poly_s.vertices_end());
+
+	{
+		boost::mutex::scoped_lock lock(skeletonCacheMutex);
+		skeletonCache.put(key, c, estimateSize(c));
+	}
+	return c.ss;
+}
+
+void StraightSkeletonCache::setMemoryBudget(std::size_t bytes)
+{
+	boost::mutex::scoped_lock lock(skeletonCacheMutex);
+	skeletonCache.setBudget(bytes);
+}
+
+std::size_t StraightSkeletonCache::getMemoryBudget()
+{
+	boost::mutex::scoped_lock lock(skeletonCacheMutex);
+	return skeletonCache.getBudget();
+}
+
+std::size_t StraightSkeletonCache::getMemoryUsage()
+{
+	boost::mutex::scoped_lock lock(skeletonCacheMutex);
+	return skeletonCache.getUsage();
+}
+
+unsigned long StraightSkeletonCache::getHits()
+{
+	boost::mutex::scoped_lock lock(skeletonCacheMutex);
+	return skeletonCache.hits();
+}
+
+unsigned long StraightSkeletonCache::getMisses()
+{
+	boost::mutex::scoped_lock lock(skeletonCacheMutex);
+	return skeletonCache.misses();
+}
+
+void StraightSkeletonCache::clear()
+{
+	boost::mutex::scoped_lock lock(skeletonCacheMutex);
+	skeletonCache.clear();
+	skeletonCache.resetCounters();
+}
+
+}
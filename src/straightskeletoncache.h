@@ -0,0 +1,73 @@
+/**
+ * @file
+ * @author  Christian Urich <christian.urich@gmail.com>
+ * @version 1.0
+ * @section LICENSE
+ *
+ * This file is part of DynaMind
+ *
+ * Copyright (C) 2013  Christian Urich
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef STRAIGHTSKELETONCACHE_H
+#define STRAIGHTSKELETONCACHE_H
+
+#include <dm.h>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+#include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
+#include <CGAL/Straight_skeleton_2.h>
+
+namespace DM {
+
+/** @brief Process wide LRU cache of interior straight skeletons
+ *
+ * Skeletons are keyed by a hash of the canonical polygon coordinates (see
+ * GeometryHash::CanonicalRing), so the same footprint hits the cache
+ * independent of its start vertex and orientation. The cache is thread safe.
+ */
+class DM_HELPER_DLL_EXPORT StraightSkeletonCache
+{
+public:
+	typedef CGAL::Exact_predicates_inexact_constructions_kernel K;
+	typedef CGAL::Straight_skeleton_2<K>                        Ss;
+	typedef boost::shared_ptr<Ss>                               SsPtr;
+
+	/** @brief Returns the interior straight skeleton of the polygon given as x,y coordinates.
+	 * The skeleton is built from the counter clockwise polygon. Returns an empty pointer if
+	 * the polygon is not simple.
+	 */
+	static SsPtr InteriorStraightSkeleton(const std::vector<double> & xy);
+
+	/** @brief Sets the memory budget in bytes, default is 64 MB. 0 disables the cache */
+	static void setMemoryBudget(std::size_t bytes);
+	static std::size_t getMemoryBudget();
+
+	/** @brief Returns the estimated memory used by the cached skeletons in bytes */
+	static std::size_t getMemoryUsage();
+
+	static unsigned long getHits();
+	static unsigned long getMisses();
+
+	/** @brief Removes all skeletons and resets the counters */
+	static void clear();
+};
+}
+
+#endif // STRAIGHTSKELETONCACHE_H
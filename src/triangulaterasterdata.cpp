@@ -23,38 +23,381 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  *
  */
-/*
+
+
 #include "triangulaterasterdata.h"
 
-void TriangulateRasterData::Triangulation(std::vector<DM::Vector3> & nodes, DM::RasterData * rData) {
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const unsigned int NO_VERTEX = (unsigned int) -1;
+
+/** NaN never compares equal, NaN values are always treated as no data */
+bool hasData(double value, const DM::RasterGeometry & raster)
+{
+	return value == value && value != raster.noValue;
+}
+
+/** Raster rows from a row major vector */
+class VectorRowReader : public DM::RasterRowReader
+{
+public:
+	VectorRowReader(const std::vector<double> & values, unsigned long width) :
+		values(values),
+		width(width)
+	{
+	}
+
+	void readRow(unsigned long y, std::vector<double> & row)
+	{
+		row.assign(values.begin() + y * width, values.begin() + (y + 1) * width);
+	}
+
+private:
+	const std::vector<double> & values;
+	unsigned long width;
+};
+
+/** Appends all strips to one mesh */
+class IndexedMeshWriter : public DM::MeshStripWriter
+{
+public:
+	IndexedMeshWriter(DM::IndexedMesh & mesh) :
+		mesh(mesh),
+		offset(mesh.numberOfVertices())
+	{
+	}
+
+	void writeStrip(const DM::IndexedMesh & strip, unsigned int)
+	{
+		mesh.vertices.insert(mesh.vertices.end(), strip.vertices.begin(), strip.vertices.end());
+		mesh.triangles.reserve(mesh.triangles.size() + strip.triangles.size());
+		for (unsigned int i = 0; i < strip.triangles.size(); i++)
+			mesh.triangles.push_back(strip.triangles[i] + offset);
+	}
+
+private:
+	DM::IndexedMesh & mesh;
+	unsigned int offset;
+};
+
+/** Returns the vertex of cell x in a row and creates it on the first use */
+unsigned int vertex(const DM::RasterGeometry & raster, const std::vector<double> & values, std::vector<unsigned int> & ids,
+					unsigned long x, unsigned long y, DM::IndexedMesh & strip, unsigned int & count)
+{
+	if (ids[x] == NO_VERTEX) {
+		ids[x] = count++;
+		strip.addVertex(x * raster.cellSizeX + raster.xOffset, y * raster.cellSizeY + raster.yOffset, values[x]);
+	}
+	return ids[x];
+}
+
+void addTriangle(DM::IndexedMesh & mesh, unsigned int v1, unsigned int v2, unsigned int v3, bool flip)
+{
+	if (flip)
+		mesh.addTriangle(v1, v3, v2);
+	else
+		mesh.addTriangle(v1, v2, v3);
+}
+
+/** Square block of size x size cells of the quadtree, the corners are cell centres */
+struct Block
+{
+	unsigned long x;
+	unsigned long y;
+	unsigned long size;
+};
+
+/** Random access to the cells of a raster stored row by row */
+class RasterCells
+{
+public:
+	RasterCells(const DM::RasterGeometry & raster, const std::vector<double> & values) :
+		raster(raster),
+		values(values)
+	{
+	}
+
+	unsigned long index(unsigned long x, unsigned long y) const {return y * raster.width + x;}
+	double value(unsigned long i) const {return values[i];}
+
+	bool valid(unsigned long x, unsigned long y) const
+	{
+		return x < raster.width && y < raster.height && hasData(values[index(x, y)], raster);
+	}
+
+	/** All cells of the block are in the raster and have data */
+	bool complete(const Block & b) const
+	{
+		for (unsigned long y = b.y; y <= b.y + b.size; y++) {
+			for (unsigned long x = b.x; x <= b.x + b.size; x++) {
+				if (!valid(x, y))
+					return false;
+			}
+		}
+		return true;
+	}
+
+	/** Largest vertical distance of the cells in the block to the fan from the block centre
+	 * to the counter clockwise ring of cell indices
+	 */
+	double fanError(const Block & b, const std::vector<unsigned long> & ring) const
+	{
+		double c[3] = {b.x + b.size / 2., b.y + b.size / 2., 0};
+		c[2] = value(index(b.x + b.size / 2, b.y + b.size / 2));
+		double error = 0;
+		for (unsigned int i = 0; i < ring.size(); i++) {
+			double p[3] = {(double) (ring[i] % raster.width), (double) (ring[i] / raster.width), value(ring[i])};
+			unsigned long j = ring[(i+1) % ring.size()];
+			double q[3] = {(double) (j % raster.width), (double) (j / raster.width), value(j)};
+
+			double d = (p[1] - q[1]) * (c[0] - q[0]) + (q[0] - p[0]) * (c[1] - q[1]);
+			unsigned long x0 = (unsigned long) std::min(c[0], std::min(p[0], q[0]));
+			unsigned long x1 = (unsigned long) std::max(c[0], std::max(p[0], q[0]));
+			unsigned long y0 = (unsigned long) std::min(c[1], std::min(p[1], q[1]));
+			unsigned long y1 = (unsigned long) std::max(c[1], std::max(p[1], q[1]));
+			for (unsigned long y = y0; y <= y1; y++) {
+				for (unsigned long x = x0; x <= x1; x++) {
+					double l1 = ((p[1] - q[1]) * (x - q[0]) + (q[0] - p[0]) * (y - q[1])) / d;
+					double l2 = ((q[1] - c[1]) * (x - q[0]) + (c[0] - q[0]) * (y - q[1])) / d;
+					double l3 = 1 - l1 - l2;
+					if (l1 < -1e-9 || l2 < -1e-9 || l3 < -1e-9)
+						continue;
+					double z = l1 * c[2] + l2 * p[2] + l3 * q[2];
+					error = std::max(error, std::fabs(z - value(index(x, y))));
+				}
+			}
+		}
+		return error;
+	}
+
+	/** Vertices of the block border that are used by any leaf, counter clockwise from the lower left corner */
+	void ring(const Block & b, const std::vector<bool> & used, std::vector<unsigned long> & r) const
+	{
+		r.clear();
+		for (unsigned long x = b.x; x < b.x + b.size; x++)
+			if (used[index(x, b.y)]) r.push_back(index(x, b.y));
+		for (unsigned long y = b.y; y < b.y + b.size; y++)
+			if (used[index(b.x + b.size, y)]) r.push_back(index(b.x + b.size, y));
+		for (unsigned long x = b.x + b.size; x > b.x; x--)
+			if (used[index(x, b.y + b.size)]) r.push_back(index(x, b.y + b.size));
+		for (unsigned long y = b.y + b.size; y > b.y; y--)
+			if (used[index(b.x, y)]) r.push_back(index(b.x, y));
+	}
+
+	/** Splits b until the blocks are within maxError or have size 1, leaves are appended */
+	void refine(const Block & b, double maxError, std::vector<Block> & leaves) const
+	{
+		std::vector<Block> stack;
+		stack.push_back(b);
+		std::vector<unsigned long> corners(4);
+		while (!stack.empty()) {
+			Block c = stack.back();
+			stack.pop_back();
+			if (c.size == 1) {
+				leaves.push_back(c);
+				continue;
+			}
+			if (complete(c)) {
+				corners[0] = index(c.x, c.y);
+				corners[1] = index(c.x + c.size, c.y);
+				corners[2] = index(c.x + c.size, c.y + c.size);
+				corners[3] = index(c.x, c.y + c.size);
+				if (fanError(c, corners) <= maxError) {
+					leaves.push_back(c);
+					continue;
+				}
+			}
+			unsigned long h = c.size / 2;
+			for (int i = 0; i < 4; i++) {
+				Block child = {c.x + (i % 2) * h, c.y + (i / 2) * h, h};
+				//Blocks without any pair of cells in the raster are dropped
+				if (child.x + 1 < raster.width && child.y + 1 < raster.height)
+					stack.push_back(child);
+			}
+		}
+	}
+
+private:
+	const DM::RasterGeometry & raster;
+	const std::vector<double> & values;
+};
+}
 
-	unsigned long Y = rData->getHeight();
-	unsigned long X = rData->getWidth();
+void TriangulateRasterData::Triangulation(const DM::RasterGeometry & raster, DM::RasterRowReader & reader, DM::MeshStripWriter & writer, unsigned long stripRows)
+{
+	unsigned long X = raster.width;
+	unsigned long Y = raster.height;
+	if (X < 2 || Y < 2)
+		return;
+	stripRows = std::max(stripRows, 1UL);
 
-	unsigned long OX = rData->getXOffset();
-	unsigned long OY = rData->getYOffset();
+	//Corners of a 2x2 block are a = (x, y-1), b = (x+1, y-1), c = (x+1, y), d = (x, y)
+	//this order is counter clockwise if both cell sizes have the same sign
+	bool flip = raster.cellSizeX * raster.cellSizeY < 0;
 
-	double noData = rData->getNoValue();
-	double lX = rData->getCellSizeX();
-	double lY = rData->getCellSizeY();
+	std::vector<double> lower;
+	std::vector<double> upper;
+	std::vector<unsigned int> lowerIds(X, NO_VERTEX);
+	std::vector<unsigned int> upperIds(X, NO_VERTEX);
 
-	//nodes.reserve(Y*X*6);
+	DM::IndexedMesh strip;
+	unsigned int count = 0;
+	unsigned int firstVertex = 0;
 
-	for (unsigned long  y = 0; y < Y; y++) {
-		for (unsigned long  x = 0; x < X; x++) {
-			double val = rData->getCell(x,y);
-			if (val == noData)
+	reader.readRow(0, lower);
+	for (unsigned long y = 1; y < Y; y++) {
+		reader.readRow(y, upper);
+		for (unsigned long x = 0; x + 1 < X; x++) {
+			bool valid[4] = {hasData(lower[x], raster), hasData(lower[x+1], raster),
+							 hasData(upper[x+1], raster), hasData(upper[x], raster)};
+			int n = valid[0] + valid[1] + valid[2] + valid[3];
+			if (n < 3)
 				continue;
-			nodes.push_back( DM::Vector3( (x-0.5) * lX + OX ,  (y-0.5) * lY + OY, val) );
-			nodes.push_back( DM::Vector3( (x+0.5) * lX + OX,   (y-0.5) * lY + OY, val) );
-			nodes.push_back( DM::Vector3( (x-0.5) * lX + OX,   (y+0.5) * lY + OY, val) );
 
-			nodes.push_back( DM::Vector3( (x-0.5) * lX + OX,   (y+0.5) * lY + OY, val) );
-			nodes.push_back( DM::Vector3( (x+0.5) * lX + OX,   (y-0.5) * lY + OY, val) );
-			nodes.push_back( DM::Vector3( (x+0.5) * lX + OX,   (y+0.5) * lY + OY, val) );
+			unsigned int corners[4];
+			int size = 0;
+			if (valid[0])
+				corners[size++] = vertex(raster, lower, lowerIds, x, y-1, strip, count);
+			if (valid[1])
+				corners[size++] = vertex(raster, lower, lowerIds, x+1, y-1, strip, count);
+			if (valid[2])
+				corners[size++] = vertex(raster, upper, upperIds, x+1, y, strip, count);
+			if (valid[3])
+				corners[size++] = vertex(raster, upper, upperIds, x, y, strip, count);
+
+			if (flip)
+				std::reverse(corners, corners + size);
+			strip.addTriangle(corners[0], corners[1], corners[2]);
+			if (size == 4)
+				strip.addTriangle(corners[0], corners[2], corners[3]);
+		}
+
+		lower.swap(upper);
+		lowerIds.swap(upperIds);
+		std::fill(upperIds.begin(), upperIds.end(), NO_VERTEX);
+
+		if (y % stripRows == 0 || y == Y - 1) {
+			writer.writeStrip(strip, firstVertex);
+			firstVertex = count;
+			strip.clear();
+		}
+	}
+}
+
+void TriangulateRasterData::Triangulation(const DM::RasterGeometry & raster, const std::vector<double> & values, DM::IndexedMesh & mesh)
+{
+	if (values.size() < raster.width * raster.height) {
+		DM::Logger(DM::Warning) << "Raster has less values than cells";
+		return;
+	}
+	VectorRowReader reader(values, raster.width);
+	IndexedMeshWriter writer(mesh);
+	Triangulation(raster, reader, writer);
+}
+
+void TriangulateRasterData::AdaptiveTriangulation(const DM::RasterGeometry &raster, const std::vector<double> &values, double maxError, DM::IndexedMesh &mesh)
+{
+	unsigned long X = raster.width;
+	unsigned long Y = raster.height;
+	if (X < 2 || Y < 2)
+		return;
+	if (values.size() < X * Y) {
+		DM::Logger(DM::Warning) << "Raster has less values than cells";
+		return;
+	}
+	maxError = std::max(maxError, 0.);
+	RasterCells cells(raster, values);
+
+	unsigned long size = 1;
+	while (size < X - 1 || size < Y - 1)
+		size *= 2;
+	Block root = {0, 0, size};
+	std::vector<Block> leaves;
+	cells.refine(root, maxError, leaves);
+
+	//Vertices added on the borders of a leaf by smaller neighbours can increase the error,
+	//these leaves are split until the mesh is stable
+	std::vector<bool> used(X * Y);
+	std::vector<unsigned long> ring;
+	bool changed = true;
+	while (changed) {
+		std::fill(used.begin(), used.end(), false);
+		foreach(const Block & b, leaves) {
+			int valid = 0;
+			for (int i = 0; i < 4; i++)
+				valid += cells.valid(b.x + (i % 2) * b.size, b.y + (i / 2) * b.size);
+			if (valid < 3)
+				continue;
+			for (int i = 0; i < 4; i++) {
+				unsigned long x = b.x + (i % 2) * b.size;
+				unsigned long y = b.y + (i / 2) * b.size;
+				if (cells.valid(x, y))
+					used[cells.index(x, y)] = true;
+			}
+		}
+
+		changed = false;
+		std::vector<Block> refined;
+		refined.reserve(leaves.size());
+		foreach(const Block & b, leaves) {
+			if (b.size > 1) {
+				cells.ring(b, used, ring);
+				if (ring.size() > 4 && cells.fanError(b, ring) > maxError) {
+					unsigned long h = b.size / 2;
+					for (int i = 0; i < 4; i++) {
+						Block child = {b.x + (i % 2) * h, b.y + (i / 2) * h, h};
+						if (child.x + 1 < X && child.y + 1 < Y)
+							cells.refine(child, maxError, refined);
+					}
+					changed = true;
+					continue;
+				}
+			}
+			refined.push_back(b);
+		}
+		leaves.swap(refined);
+	}
+
+	//Size 1 blocks are triangulated like in Triangulation, bigger ones as fan from the centre
+	bool flip = raster.cellSizeX * raster.cellSizeY < 0;
+	std::vector<unsigned int> ids(X * Y, NO_VERTEX);
+	unsigned int triangles_before = mesh.numberOfTriangles();
+	foreach(const Block & b, leaves) {
+		std::vector<unsigned long> fan;
+		bool centre = b.size > 1;
+		if (centre) {
+			cells.ring(b, used, fan);
+			fan.insert(fan.begin(), cells.index(b.x + b.size / 2, b.y + b.size / 2));
+		} else {
+			if (cells.valid(b.x, b.y)) fan.push_back(cells.index(b.x, b.y));
+			if (cells.valid(b.x + 1, b.y)) fan.push_back(cells.index(b.x + 1, b.y));
+			if (cells.valid(b.x + 1, b.y + 1)) fan.push_back(cells.index(b.x + 1, b.y + 1));
+			if (cells.valid(b.x, b.y + 1)) fan.push_back(cells.index(b.x, b.y + 1));
+			if (fan.size() < 3)
+				continue;
+		}
+
+		std::vector<unsigned int> v(fan.size());
+		for (unsigned int i = 0; i < fan.size(); i++) {
+			if (ids[fan[i]] == NO_VERTEX) {
+				unsigned long x = fan[i] % X;
+				unsigned long y = fan[i] / X;
+				ids[fan[i]] = mesh.addVertex(x * raster.cellSizeX + raster.xOffset, y * raster.cellSizeY + raster.yOffset, values[fan[i]]);
+			}
+			v[i] = ids[fan[i]];
+		}
 
+		if (centre) {
+			for (unsigned int i = 1; i < v.size(); i++)
+				addTriangle(mesh, v[0], v[i], v[i % (v.size() - 1) + 1], flip);
+		} else {
+			for (unsigned int i = 1; i + 1 < v.size(); i++)
+				addTriangle(mesh, v[0], v[i], v[i+1], flip);
 		}
 	}
 
+	DM::Logger(DM::Debug) << "Adaptive TIN with " << (int) (mesh.numberOfTriangles() - triangles_before) << " triangles, regular TIN with " << (int) (2 * (X - 1) * (Y - 1));
 }
-*/
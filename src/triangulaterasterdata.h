@@ -23,18 +23,76 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  *
  */
-/*
+
 #ifndef TRIANGULATERASTERDATA_H
 #define TRIANGULATERASTERDATA_H
 
 #include <dm.h>
+#include <indexedmesh.h>
+#include <vector>
+
+namespace DM {
 
+/** @brief Size and placement of a raster, cell (x, y) is centred at
+ * (x * cellSizeX + xOffset, y * cellSizeY + yOffset). Cells with noValue or NaN have no data.
+ */
+struct RasterGeometry
+{
+	unsigned long width;
+	unsigned long height;
+	double xOffset;
+	double yOffset;
+	double cellSizeX;
+	double cellSizeY;
+	double noValue;
+};
+
+/** @brief Provides the raster one row at a time */
+class DM_HELPER_DLL_EXPORT RasterRowReader
+{
+public:
+	virtual ~RasterRowReader() {}
+	/** @brief Writes the width values of row y to values */
+	virtual void readRow(unsigned long y, std::vector<double> & values) = 0;
+};
+
+/** @brief Receives the triangulation strip by strip
+ *
+ * strip holds the vertices created for the strip and the triangles of the strip. Vertex
+ * indices count from the first vertex of the whole triangulation, the first vertex of
+ * strip has the index firstVertex.
+ */
+class DM_HELPER_DLL_EXPORT MeshStripWriter
+{
+public:
+	virtual ~MeshStripWriter() {}
+	virtual void writeStrip(const IndexedMesh & strip, unsigned int firstVertex) = 0;
+};
+}
 
 class DM_HELPER_DLL_EXPORT TriangulateRasterData
 {
 public:
-	static void Triangulation(std::vector<DM::Vector3> & nodes, DM::RasterData * rData);
+	/** @brief Triangulates the raster with a vertex in the centre of every cell with data.
+	 *
+	 * Rows are read one by one and the triangles are written every stripRows rows, only two
+	 * rows and the current strip are kept in memory. Vertices are shared between triangles,
+	 * 2x2 cells with one no data value are covered by one triangle. Triangles are counter
+	 * clockwise in x, y.
+	 */
+	static void Triangulation(const DM::RasterGeometry & raster, DM::RasterRowReader & reader, DM::MeshStripWriter & writer, unsigned long stripRows = 256);
+
+	/** @brief Appends the triangulation of a raster stored row by row in values to mesh */
+	static void Triangulation(const DM::RasterGeometry & raster, const std::vector<double> & values, DM::IndexedMesh & mesh);
+
+	/** @brief Appends an adaptive triangulation of the raster to mesh, the vertical distance
+	 * between the surface and the cell values is at most maxError.
+	 *
+	 * The raster is split into a quadtree, a block with data in all cells that is
+	 * approximated within maxError by a fan from its centre becomes one leaf. The fan uses the
+	 * corners of all neighbouring leaves on the border, the mesh has no T-junctions.
+	 */
+	static void AdaptiveTriangulation(const DM::RasterGeometry & raster, const std::vector<double> & values, double maxError, DM::IndexedMesh & mesh);
 };
 
 #endif // TRIANGULATERASTERDATA_H
-*/
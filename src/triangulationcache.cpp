@@ -0,0 +1,189 @@
+/**
+ * @file
+ * @author  Christian Urich <christian.urich@gmail.com>
+ * @version 1.0
+ * @section LICENSE
+ *
+ * This file is part of DynaMind
+ *
+ * Copyright (C) 2013  Christian Urich
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "triangulationcache.h"
+#include "geometryhash.h"
+#include "lrucache.h"
+#include "cgaltriangulation.h"
+#include "cgalregulartriangulation.h"
+
+#include <tbvectordata.h>
+#include <boost/thread/mutex.hpp>
+
+namespace DM {
+
+namespace {
+
+enum TriangulationType {
+	CONSTRAINED,
+	REGULAR
+};
+
+struct CachedTriangulation {
+	std::vector<double> geometry;
+	IndexedMesh mesh;
+	bool valid;
+};
+
+typedef LruCache<boost::uint64_t, CachedTriangulation> TriangulationLruCache;
+
+boost::mutex triangulationCacheMutex;
+TriangulationLruCache triangulationCache(0);
+
+std::size_t estimateSize(const CachedTriangulation & c)
+{
+	return sizeof(CachedTriangulation)
+			+ c.geometry.size() * sizeof(double)
+			+ c.mesh.vertices.size() * sizeof(double)
+			+ c.mesh.triangles.size() * sizeof(unsigned int);
+}
+
+void addRing(const std::vector<DM::Node*> & nodes, std::vector<double> & geometry)
+{
+	double v[3];
+	geometry.push_back(nodes.size());
+	foreach(DM::Node * n, nodes) {
+		n->get(v);
+		geometry.insert(geometry.end(), v, v + 3);
+	}
+}
+
+/** Everything the triangulation depends on, compared on lookup to rule out hash collisions */
+void faceGeometry(DM::System * sys, DM::Face * f, TriangulationType type, double meshsize, std::vector<double> & geometry)
+{
+	geometry.push_back(type);
+	geometry.push_back(meshsize);
+	addRing(TBVectorData::getNodeListFromFace(sys, f), geometry);
+	foreach(DM::Face * hole, f->getHolePointers())
+		addRing(hole->getNodePointers(), geometry);
+}
+
+bool lookup(boost::uint64_t key, const std::vector<double> & geometry, CachedTriangulation & cached)
+{
+	boost::mutex::scoped_lock lock(triangulationCacheMutex);
+	return triangulationCache.get(key, cached) && cached.geometry == geometry;
+}
+
+void store(boost::uint64_t key, const CachedTriangulation & c)
+{
+	boost::mutex::scoped_lock lock(triangulationCacheMutex);
+	triangulationCache.put(key, c, estimateSize(c));
+}
+}
+
+bool TriangulationCache::Triangulation(System *sys, Face *f, IndexedMesh &mesh)
+{
+	if (getMemoryBudget() == 0)
+		return CGALTriangulation::Triangulation(sys, f, mesh);
+
+	CachedTriangulation c;
+	faceGeometry(sys, f, CONSTRAINED, 0, c.geometry);
+	GeometryHash hash;
+	hash.add(c.geometry);
+	boost::uint64_t key = hash.value();
+
+	CachedTriangulation cached;
+	if (lookup(key, c.geometry, cached)) {
+		mesh.append(cached.mesh);
+		return cached.valid;
+	}
+
+	c.valid = CGALTriangulation::Triangulation(sys, f, c.mesh);
+	store(key, c);
+	mesh.append(c.mesh);
+	return c.valid;
+}
+
+void TriangulationCache::RegularTriangulation(System *sys, Face *f, double meshsize, IndexedMesh &mesh)
+{
+	CachedTriangulation c;
+	bool enabled = getMemoryBudget() > 0;
+	boost::uint64_t key = 0;
+	if (enabled) {
+		faceGeometry(sys, f, REGULAR, meshsize, c.geometry);
+		GeometryHash hash;
+		hash.add(c.geometry);
+		key = hash.value();
+
+		CachedTriangulation cached;
+		if (lookup(key, c.geometry, cached)) {
+			mesh.append(cached.mesh);
+			return;
+		}
+	}
+
+	CGALRegularTriangulation::Triangulation(sys, f, meshsize, c.mesh);
+	c.valid = true;
+
+	if (enabled)
+		store(key, c);
+	mesh.append(c.mesh);
+}
+
+void TriangulationCache::setMemoryBudget(std::size_t bytes)
+{
+	boost::mutex::scoped_lock lock(triangulationCacheMutex);
+	triangulationCache.setBudget(bytes);
+}
+
+std::size_t TriangulationCache::getMemoryBudget()
+{
+	boost::mutex::scoped_lock lock(triangulationCacheMutex);
+	return triangulationCache.getBudget();
+}
+
+std::size_t TriangulationCache::getMemoryUsage()
+{
+	boost::mutex::scoped_lock lock(triangulationCacheMutex);
+	return triangulationCache.getUsage();
+}
+
+unsigned long TriangulationCache::getHits()
+{
+	boost::mutex::scoped_lock lock(triangulationCacheMutex);
+	return triangulationCache.hits();
+}
+
+unsigned long TriangulationCache::getMisses()
+{
+	boost::mutex::scoped_lock lock(triangulationCacheMutex);
+	return triangulationCache.misses();
+}
+
+void TriangulationCache::invalidate()
+{
+	boost::mutex::scoped_lock lock(triangulationCacheMutex);
+	triangulationCache.clear();
+}
+
+void TriangulationCache::clear()
+{
+	boost::mutex::scoped_lock lock(triangulationCacheMutex);
+	triangulationCache.clear();
+	triangulationCache.resetCounters();
+}
+
+}
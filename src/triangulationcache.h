@@ -0,0 +1,72 @@
+/**
+ * @file
+ * @author  Christian Urich <christian.urich@gmail.com>
+ * @version 1.0
+ * @section LICENSE
+ *
+ * This file is part of DynaMind
+ *
+ * Copyright (C) 2013  Christian Urich
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+
+#ifndef TRIANGULATIONCACHE_H
+#define TRIANGULATIONCACHE_H
+
+#include <dm.h>
+#include <indexedmesh.h>
+
+namespace DM {
+
+/** @brief Process wide LRU cache of face triangulations
+ *
+ * Triangulations are keyed by a hash of the node coordinates of the face and
+ * its holes, the triangulation type and the mesh size. A face that changed
+ * gets a new key, old entries are dropped when the memory budget is exceeded.
+ * The cache is disabled by default (budget 0), CGALGeometry::FaceTriangulation
+ * and CGALGeometry::RegularFaceTriangulation use it once a budget is set.
+ * The cache is thread safe.
+ */
+class DM_HELPER_DLL_EXPORT TriangulationCache
+{
+public:
+	/** @brief Appends the constrained triangulation of the face to mesh, see CGALTriangulation::Triangulation */
+	static bool Triangulation(DM::System * sys, DM::Face * f, DM::IndexedMesh & mesh);
+
+	/** @brief Appends the regular triangulation of the face to mesh, see CGALRegularTriangulation::Triangulation */
+	static void RegularTriangulation(DM::System * sys, DM::Face * f, double meshsize, DM::IndexedMesh & mesh);
+
+	/** @brief Sets the memory budget in bytes, 0 disables the cache */
+	static void setMemoryBudget(std::size_t bytes);
+	static std::size_t getMemoryBudget();
+
+	/** @brief Returns the estimated memory used by the cached triangulations in bytes */
+	static std::size_t getMemoryUsage();
+
+	static unsigned long getHits();
+	static unsigned long getMisses();
+
+	/** @brief Removes all triangulations, e.g. after the geometry was replaced */
+	static void invalidate();
+
+	/** @brief Removes all triangulations and resets the counters */
+	static void clear();
+};
+}
+
+#endif // TRIANGULATIONCACHE_H
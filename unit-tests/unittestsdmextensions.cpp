@@ -5,6 +5,21 @@
 #include <cgalgeometry.h>
 #include <cgalgeometry_p.h>
 #include <cgalsearchoperations.h>
+#include <preparedface.h>
+#include <straightskeleton.h>
+#include <straightskeletoncache.h>
+#include <affinetransformation.h>
+#include <indexedmesh.h>
+#include <cgaltriangulation.h>
+#include <cgalregulartriangulation.h>
+#include <planeprojection.h>
+#include <triangulationcache.h>
+#include <meshsizefield.h>
+#include <meshtopology.h>
+#include <triangulaterasterdata.h>
+#include <littlegeometryhelpers.h>
+#include <geometrylogger.h>
+#include <spatialsearchnearestnodes.h>
 #include "cgalskeletonisation.h"
 #include <dmlog.h>
 #include <dmlogger.h>
@@ -14,10 +29,57 @@
 #include <CGAL/Simple_cartesian.h>
 #include <CGAL/Polyhedron_3.h>
 #include <iostream>
+#include <map>
+#include <algorithm>
 
 
 namespace {
 
+int countEvaluation(int & counter)
+{
+	return ++counter;
+}
+
+class TestRowReader : public DM::RasterRowReader
+{
+public:
+	TestRowReader(const std::vector<double> & values, unsigned long width) : values(values), width(width), rows(0) {}
+
+	void readRow(unsigned long y, std::vector<double> & row)
+	{
+		row.assign(values.begin() + y * width, values.begin() + (y + 1) * width);
+		rows++;
+	}
+
+	const std::vector<double> & values;
+	unsigned long width;
+	int rows;
+};
+
+/** Checks the firstVertex contract and appends the strips to one mesh */
+class TestStripWriter : public DM::MeshStripWriter
+{
+public:
+	TestStripWriter() : strips(0), earlierReferences(0) {}
+
+	void writeStrip(const DM::IndexedMesh & strip, unsigned int firstVertex)
+	{
+		EXPECT_EQ(firstVertex, mesh.numberOfVertices());
+		for (unsigned int i = 0; i < strip.triangles.size(); i++) {
+			EXPECT_LT(strip.triangles[i], firstVertex + strip.numberOfVertices());
+			if (strip.triangles[i] < firstVertex)
+				earlierReferences++;
+		}
+		mesh.vertices.insert(mesh.vertices.end(), strip.vertices.begin(), strip.vertices.end());
+		mesh.triangles.insert(mesh.triangles.end(), strip.triangles.begin(), strip.triangles.end());
+		strips++;
+	}
+
+	DM::IndexedMesh mesh;
+	int strips;
+	int earlierReferences;
+};
+
 void addRectangleWithHole(DM::System* sys, DM::View v)
 {
 
@@ -1147,4 +1209,1314 @@ TEST_F(UnitTestsDMExtensions,calculateAreaR9){
 	delete sys;
 }
 
+TEST_F(UnitTestsDMExtensions,checkOrientation){
+	ostream *out = &cout;
+	DM::Log::init(new DM::OStreamLogSink(*out), DM::Standard);
+	DM::System * sys = new DM::System();
+
+	DM::Node * n1 = sys->addNode(DM::Node(0,0,0));
+	DM::Node * n2 = sys->addNode(DM::Node(2,0,0));
+	DM::Node * n3 = sys->addNode(DM::Node(2,2,0));
+	DM::Node * n4 = sys->addNode(DM::Node(1,1,0));
+	DM::Node * n5 = sys->addNode(DM::Node(0,2,0));
+
+	std::vector<DM::Node * > nodes;
+	nodes.push_back(n1);
+	nodes.push_back(n2);
+	nodes.push_back(n3);
+	nodes.push_back(n4);
+	nodes.push_back(n5);
+	nodes.push_back(n1);
+
+	EXPECT_TRUE(DM::CGALGeometry::CheckOrientation(nodes));
+	EXPECT_TRUE(DM::CGALGeometry::CheckOrientation(nodes, true));
+	EXPECT_TRUE(DM::CGALGeometry::IsSimple(nodes));
+
+	std::reverse(nodes.begin(), nodes.end());
+	EXPECT_FALSE(DM::CGALGeometry::CheckOrientation(nodes));
+	EXPECT_FALSE(DM::CGALGeometry::CheckOrientation(nodes, true));
+
+	delete sys;
+}
+
+TEST_F(UnitTestsDMExtensions,preparedFace){
+	ostream *out = &cout;
+	DM::Log::init(new DM::OStreamLogSink(*out), DM::Standard);
+	DM::System * sys = new DM::System();
+
+	DM::Node * n1 = sys->addNode(DM::Node(0,0,0));
+	DM::Node * n2 = sys->addNode(DM::Node(1,0,0));
+	DM::Node * n3 = sys->addNode(DM::Node(1,1,0));
+	DM::Node * n4 = sys->addNode(DM::Node(0,1,0));
+
+	std::vector<DM::Node * > nodes;
+	nodes.push_back(n1);
+	nodes.push_back(n2);
+	nodes.push_back(n3);
+	nodes.push_back(n4);
+
+	DM::Face * f = sys->addFace(nodes);
+
+	DM::Node * n1_h = sys->addNode(DM::Node(0.3,0.1,0));
+	DM::Node * n2_h = sys->addNode(DM::Node(0.3,0.3,0));
+	DM::Node * n3_h = sys->addNode(DM::Node(0.6,0.3,0));
+	DM::Node * n4_h = sys->addNode(DM::Node(0.6,0.1,0));
+
+	std::vector<DM::Node * > nodes_h;
+	nodes_h.push_back(n1_h);
+	nodes_h.push_back(n2_h);
+	nodes_h.push_back(n3_h);
+	nodes_h.push_back(n4_h);
+
+	f->addHole(nodes_h);
+
+	DM::PreparedFace pf(f);
+
+	EXPECT_FALSE(pf.contains(0.5, 0.2));
+	EXPECT_TRUE(pf.contains(0.7, 0.7));
+	EXPECT_TRUE(pf.contains(1.0, 0.5));
+	EXPECT_FALSE(pf.contains(0.3, 0.2));
+	EXPECT_FALSE(pf.contains(1.5, 1.5));
+
+	std::vector<double> x;
+	std::vector<double> y;
+	for (int i = 0; i < 10; i++) {
+		for (int j = 0; j < 10; j++) {
+			x.push_back(0.05 + i * 0.1);
+			y.push_back(0.05 + j * 0.1);
+		}
+	}
+	std::vector<int> inside;
+	pf.contains(x, y, inside);
+	ASSERT_EQ(inside.size(), x.size());
+	for (unsigned int i = 0; i < inside.size(); i++)
+		EXPECT_EQ(inside[i] == 1, DM::CGALGeometry::NodeWithinFace(f, DM::Node(x[i], y[i], 0)));
+
+	delete sys;
+}
+
+TEST_F(UnitTestsDMExtensions,pointsInFaces){
+	ostream *out = &cout;
+	DM::Log::init(new DM::OStreamLogSink(*out), DM::Standard);
+	DM::System * sys = new DM::System();
+
+	DM::View parcels("PARCEL", DM::FACE, DM::WRITE);
+	DM::View inlets("INLET", DM::NODE, DM::WRITE);
+
+	addRectangleWithHole(sys, parcels);
+
+	DM::Node * n1 = sys->addNode(DM::Node(3,1,0));
+	DM::Node * n2 = sys->addNode(DM::Node(4,1,0));
+	DM::Node * n3 = sys->addNode(DM::Node(4,2,0));
+	DM::Node * n4 = sys->addNode(DM::Node(3,2,0));
+
+	std::vector<DM::Node * > nodes;
+	nodes.push_back(n1);
+	nodes.push_back(n2);
+	nodes.push_back(n3);
+	nodes.push_back(n4);
+	nodes.push_back(n1);
+	sys->addFace(nodes, parcels);
+
+	sys->addNode(1.1, 1.1, 0, inlets);
+	sys->addNode(1.5, 1.5, 0, inlets);
+	sys->addNode(3.5, 1.5, 0, inlets);
+	sys->addNode(5.0, 1.5, 0, inlets);
+
+	std::vector<int> containingFaces = DM::CGALGeometry::PointsInFaces(sys, inlets, parcels);
+	ASSERT_EQ(containingFaces.size(), 4);
+	EXPECT_EQ(containingFaces[0], 0);
+	EXPECT_EQ(containingFaces[1], -1);
+	EXPECT_EQ(containingFaces[2], 1);
+	EXPECT_EQ(containingFaces[3], -1);
+
+	delete sys;
+}
+
+TEST_F(UnitTestsDMExtensions,calculateMinBoundingBoxes){
+	ostream *out = &cout;
+	DM::Log::init(new DM::OStreamLogSink(*out), DM::Standard);
+	DM::System * sys = new DM::System();
+	DM::View footprints("FOOTPRINT", DM::FACE, DM::WRITE);
+
+	const double pi =  3.14159265358979323846;
+	double alpha = 30. / 180. * pi;
+	double l = 4;
+	double w = 2;
+
+	std::vector<DM::Node * > nodes;
+	nodes.push_back(sys->addNode(DM::Node(100, 200, 0)));
+	nodes.push_back(sys->addNode(DM::Node(100 + l * cos(alpha), 200 + l * sin(alpha), 0)));
+	nodes.push_back(sys->addNode(DM::Node(100 + l * cos(alpha) - w * sin(alpha), 200 + l * sin(alpha) + w * cos(alpha), 0)));
+	nodes.push_back(sys->addNode(DM::Node(100 - w * sin(alpha), 200 + w * cos(alpha), 0)));
+	nodes.push_back(nodes[0]);
+	sys->addFace(nodes, footprints);
+
+	std::vector<DM::Node * > nodes_y;
+	nodes_y.push_back(sys->addNode(DM::Node(0,0,0)));
+	nodes_y.push_back(sys->addNode(DM::Node(0,2,0)));
+	nodes_y.push_back(sys->addNode(DM::Node(1,2,0)));
+	nodes_y.push_back(sys->addNode(DM::Node(1,0,0)));
+	sys->addFace(nodes_y, footprints);
+
+	std::vector<double> angles;
+	std::vector<double> lengths;
+	std::vector<double> widths;
+	std::vector<double> corners;
+	DM::CGALGeometry::CalculateMinBoundingBoxes(sys, footprints, angles, lengths, widths, corners);
+
+	ASSERT_EQ(angles.size(), 2);
+	ASSERT_EQ(corners.size(), 16);
+	EXPECT_NEAR(angles[0], 30, 0.0001);
+	EXPECT_NEAR(lengths[0], l, 0.0001);
+	EXPECT_NEAR(widths[0], w, 0.0001);
+
+	EXPECT_NEAR(angles[1], 90, 0.0001);
+	EXPECT_NEAR(lengths[1], 2, 0.0001);
+	EXPECT_NEAR(widths[1], 1, 0.0001);
+
+	delete sys;
+}
+
+TEST_F(UnitTestsDMExtensions,multiOffsetPolygon){
+	ostream *out = &cout;
+	DM::Log::init(new DM::OStreamLogSink(*out), DM::Standard);
+	DM::System * sys = new DM::System();
+
+	DM::Node * n1 = sys->addNode(DM::Node(0,0,0));
+	DM::Node * n2 = sys->addNode(DM::Node(0,1,0));
+	DM::Node * n3 = sys->addNode(DM::Node(1,1,0));
+	DM::Node * n4 = sys->addNode(DM::Node(1,0,0));
+
+	std::vector<DM::Node * > nodes;
+	nodes.push_back(n1);
+	nodes.push_back(n2);
+	nodes.push_back(n3);
+	nodes.push_back(n4);
+
+	std::vector<double> offsets;
+	offsets.push_back(0.1);
+	offsets.push_back(0.2);
+	offsets.push_back(0.6);
+
+	std::vector<std::vector<std::vector<DM::Node> > > results = DM::CGALGeometry::OffsetPolygon(nodes, offsets);
+	ASSERT_EQ(results.size(), 3);
+
+	for (int i = 0; i < 2; i++) {
+		ASSERT_EQ(results[i].size(), 1);
+		std::vector<DM::Node> single = DM::CGALGeometry::OffsetPolygon(nodes, offsets[i])[0];
+		ASSERT_EQ(results[i][0].size(), single.size());
+		double l = 1. - 2. * offsets[i];
+		EXPECT_NEAR(TBVectorData::calculateDistance(&results[i][0][0], &results[i][0][1]), l, 0.00001);
+	}
+	DM::StraightSkeleton ss(nodes);
+	ASSERT_TRUE(ss.isValid());
+	EXPECT_EQ(ss.offset(0.2)[0].size(), 4);
+
+	delete sys;
+}
+
+TEST_F(UnitTestsDMExtensions,straightSkeletonCache){
+	ostream *out = &cout;
+	DM::Log::init(new DM::OStreamLogSink(*out), DM::Standard);
+	DM::System * sys = new DM::System();
+
+	DM::StraightSkeletonCache::clear();
+
+	DM::Node * n1 = sys->addNode(DM::Node(0,0,0));
+	DM::Node * n2 = sys->addNode(DM::Node(0,1,0));
+	DM::Node * n3 = sys->addNode(DM::Node(2,1,0));
+	DM::Node * n4 = sys->addNode(DM::Node(2,0,0));
+
+	std::vector<DM::Node * > nodes;
+	nodes.push_back(n1);
+	nodes.push_back(n2);
+	nodes.push_back(n3);
+	nodes.push_back(n4);
+
+	DM::CGALGeometry::OffsetPolygon(nodes, 0.1);
+	EXPECT_EQ(DM::StraightSkeletonCache::getMisses(), 1);
+
+	//Same polygon with a different start node and orientation
+	std::vector<DM::Node * > nodes_r;
+	nodes_r.push_back(n3);
+	nodes_r.push_back(n2);
+	nodes_r.push_back(n1);
+	nodes_r.push_back(n4);
+	std::vector<DM::Node> offset = DM::CGALGeometry::OffsetPolygon(nodes_r, 0.1)[0];
+	EXPECT_EQ(offset.size(), 4);
+	EXPECT_EQ(DM::StraightSkeletonCache::getHits(), 1);
+	EXPECT_EQ(DM::StraightSkeletonCache::getMisses(), 1);
+	EXPECT_GT(DM::StraightSkeletonCache::getMemoryUsage(), 0);
+
+	DM::StraightSkeletonCache::setMemoryBudget(0);
+	EXPECT_EQ(DM::StraightSkeletonCache::getMemoryUsage(), 0);
+	DM::StraightSkeletonCache::setMemoryBudget(64 * 1024 * 1024);
+	DM::StraightSkeletonCache::clear();
+
+	delete sys;
+}
+
+TEST_F(UnitTestsDMExtensions,affineTransformation){
+	ostream *out = &cout;
+	DM::Log::init(new DM::OStreamLogSink(*out), DM::Standard);
+	DM::System * sys = new DM::System();
+
+	double rotate[6];
+	DM::AffineTransformation::Rotation2D(90, rotate);
+
+	std::vector<double> x;
+	std::vector<double> y;
+	std::vector<double> xy;
+	for (int i = 0; i < 5; i++) {
+		x.push_back(i);
+		y.push_back(1);
+		xy.push_back(i);
+		xy.push_back(1);
+	}
+	DM::AffineTransformation::Transform2D(&x[0], &y[0], x.size(), rotate);
+	DM::AffineTransformation::Transform2D(&xy[0], x.size(), rotate);
+	for (int i = 0; i < 5; i++) {
+		EXPECT_NEAR(x[i], -1, 0.000001);
+		EXPECT_NEAR(y[i], i, 0.000001);
+		EXPECT_NEAR(xy[2*i], -1, 0.000001);
+		EXPECT_NEAR(xy[2*i+1], i, 0.000001);
+	}
+
+	std::vector<DM::Node * > nodes;
+	nodes.push_back(sys->addNode(DM::Node(1,0,3)));
+	nodes.push_back(sys->addNode(DM::Node(0,2,4)));
+	DM::CGALGeometry::RotateNodesInPlace(nodes, 90);
+	EXPECT_NEAR(nodes[0]->getX(), 0, 0.000001);
+	EXPECT_NEAR(nodes[0]->getY(), 1, 0.000001);
+	EXPECT_NEAR(nodes[0]->getZ(), 3, 0.000001);
+	EXPECT_NEAR(nodes[1]->getX(), -2, 0.000001);
+	EXPECT_NEAR(nodes[1]->getY(), 0, 0.000001);
+
+	double translate[12] = {1,0,0,10, 0,1,0,20, 0,0,1,30};
+	std::vector<double> xyz(6, 1);
+	DM::AffineTransformation::Transform3D(&xyz[0], 2, translate);
+	EXPECT_DOUBLE_EQ(xyz[3], 11);
+	EXPECT_DOUBLE_EQ(xyz[4], 21);
+	EXPECT_DOUBLE_EQ(xyz[5], 31);
+
+	delete sys;
+}
+
+TEST_F(UnitTestsDMExtensions, triangulationIndexedMesh) {
+	ostream *out = &cout;
+	DM::Log::init(new DM::OStreamLogSink(*out), DM::Standard);
+	DM::System * sys = new DM::System();
+
+	std::vector<DM::Node * > nodes;
+	nodes.push_back(sys->addNode(DM::Node(1,1,0)));
+	nodes.push_back(sys->addNode(DM::Node(3,1,0)));
+	nodes.push_back(sys->addNode(DM::Node(3,3,0)));
+	nodes.push_back(sys->addNode(DM::Node(1,3,0)));
+	nodes.push_back(nodes[0]);
+
+	std::vector<DM::Node * > nodes_h;
+	nodes_h.push_back(sys->addNode(DM::Node(1.5,1.5,0)));
+	nodes_h.push_back(sys->addNode(DM::Node(2.5,1.5,0)));
+	nodes_h.push_back(sys->addNode(DM::Node(2.5,2.5,0)));
+	nodes_h.push_back(sys->addNode(DM::Node(1.5,2.5,0)));
+	nodes_h.push_back(nodes_h[0]);
+
+	DM::Face * f = sys->addFace(nodes);
+	f->addHole(nodes_h);
+
+	DM::IndexedMesh mesh;
+	EXPECT_TRUE(DM::CGALGeometry::FaceTriangulation(sys, f, mesh));
+	EXPECT_EQ(mesh.numberOfVertices(), 8);
+	EXPECT_EQ(mesh.numberOfTriangles(), 8);
+
+	double a_triangles = 0;
+	for (unsigned int i = 0; i < mesh.numberOfTriangles(); i++) {
+		const double * v1 = &mesh.vertices[3*mesh.triangles[3*i]];
+		const double * v2 = &mesh.vertices[3*mesh.triangles[3*i+1]];
+		const double * v3 = &mesh.vertices[3*mesh.triangles[3*i+2]];
+		a_triangles += fabs((v2[0]-v1[0])*(v3[1]-v1[1]) - (v3[0]-v1[0])*(v2[1]-v1[1])) / 2.;
+	}
+	EXPECT_DOUBLE_EQ(TBVectorData::CalculateArea(sys, f), a_triangles);
+
+	//Node output is the expanded indexed mesh
+	std::vector<DM::Node> tnodes = DM::CGALGeometry::FaceTriangulation(sys, f);
+	EXPECT_EQ(tnodes.size(), mesh.triangles.size());
+
+	//Second face is appended behind the first one
+	DM::IndexedMesh mesh2;
+	mesh2.append(mesh);
+	EXPECT_TRUE(DM::CGALGeometry::FaceTriangulation(sys, f, mesh2));
+	EXPECT_EQ(mesh2.numberOfVertices(), 16);
+	EXPECT_EQ(mesh2.triangles[mesh.triangles.size()], mesh.triangles[0] + 8);
+
+	delete sys;
+}
+
+TEST_F(UnitTestsDMExtensions,triangulateView){
+	ostream *out = &cout;
+	DM::Log::init(new DM::OStreamLogSink(*out), DM::Standard);
+	DM::System * sys = new DM::System();
+
+	DM::View buildings("BUILDING", DM::FACE, DM::WRITE);
+	addRectangleWithHole(sys, buildings);
+
+	//Wall
+	std::vector<DM::Node * > nodes;
+	nodes.push_back(sys->addNode(DM::Node(0,0,0)));
+	nodes.push_back(sys->addNode(DM::Node(2,0,0)));
+	nodes.push_back(sys->addNode(DM::Node(2,0,3)));
+	nodes.push_back(sys->addNode(DM::Node(0,0,3)));
+	nodes.push_back(nodes[0]);
+	sys->addFace(nodes, buildings);
+
+	DM::IndexedMesh mesh;
+	std::vector<unsigned int> offsets;
+	DM::CGALGeometry::TriangulateView(sys, buildings, mesh, offsets);
+
+	ASSERT_EQ(offsets.size(), 3);
+	EXPECT_EQ(offsets[0], 0);
+	EXPECT_EQ(offsets[1], 8);
+	EXPECT_EQ(offsets[2], 10);
+	EXPECT_EQ(mesh.numberOfTriangles(), 10);
+
+	//Same result as the triangulation of the single faces
+	const std::vector<DM::Component*> & faces = sys->getAllComponentsInView(buildings);
+	DM::IndexedMesh reference;
+	for (unsigned int i = 0; i < faces.size(); i++)
+		DM::CGALGeometry::FaceTriangulation(sys, static_cast<DM::Face*>(faces[i]), reference);
+	ASSERT_EQ(mesh.vertices.size(), reference.vertices.size());
+	ASSERT_EQ(mesh.triangles.size(), reference.triangles.size());
+	for (unsigned int i = 0; i < mesh.vertices.size(); i++)
+		EXPECT_DOUBLE_EQ(mesh.vertices[i], reference.vertices[i]);
+	for (unsigned int i = 0; i < mesh.triangles.size(); i++)
+		EXPECT_EQ(mesh.triangles[i], reference.triangles[i]);
+
+	//Wall triangles stay in the plane y = 0
+	for (unsigned int i = 3 * offsets[1]; i < 3 * offsets[2]; i++)
+		EXPECT_NEAR(mesh.vertices[3*mesh.triangles[i]+1], 0, 0.000001);
+
+	delete sys;
+}
+
+TEST_F(UnitTestsDMExtensions,convexTriangulation){
+	ostream *out = &cout;
+	DM::Log::init(new DM::OStreamLogSink(*out), DM::Standard);
+	DM::System * sys = new DM::System();
+
+	std::vector<DM::Node * > nodes;
+	nodes.push_back(sys->addNode(DM::Node(0,0,0)));
+	nodes.push_back(sys->addNode(DM::Node(2,0,0)));
+	nodes.push_back(sys->addNode(DM::Node(3,1,0)));
+	nodes.push_back(sys->addNode(DM::Node(2,2,0)));
+	nodes.push_back(sys->addNode(DM::Node(0,2,0)));
+	nodes.push_back(nodes[0]);
+	DM::Face * convex = sys->addFace(nodes);
+
+	//Node on the edge
+	nodes.insert(nodes.begin() + 1, sys->addNode(DM::Node(1,0,0)));
+	DM::Face * collinear = sys->addFace(nodes);
+
+	//L shape
+	std::vector<DM::Node * > nodes_l;
+	nodes_l.push_back(sys->addNode(DM::Node(0,0,0)));
+	nodes_l.push_back(sys->addNode(DM::Node(2,0,0)));
+	nodes_l.push_back(sys->addNode(DM::Node(2,1,0)));
+	nodes_l.push_back(sys->addNode(DM::Node(1,1,0)));
+	nodes_l.push_back(sys->addNode(DM::Node(1,2,0)));
+	nodes_l.push_back(sys->addNode(DM::Node(0,2,0)));
+	nodes_l.push_back(nodes_l[0]);
+	DM::Face * concave = sys->addFace(nodes_l);
+
+	FaceRings rings;
+	DM::IndexedMesh mesh;
+	CGALTriangulation::PrepareFace(sys, convex, rings);
+	EXPECT_TRUE(CGALTriangulation::ConvexTriangulation(rings, mesh));
+	CGALTriangulation::PrepareFace(sys, collinear, rings);
+	EXPECT_FALSE(CGALTriangulation::ConvexTriangulation(rings, mesh));
+	CGALTriangulation::PrepareFace(sys, concave, rings);
+	EXPECT_FALSE(CGALTriangulation::ConvexTriangulation(rings, mesh));
+	EXPECT_EQ(mesh.numberOfVertices(), 5);
+	EXPECT_EQ(mesh.numberOfTriangles(), 3);
+
+	DM::Face * faces[3] = {convex, collinear, concave};
+	for (int f = 0; f < 3; f++) {
+		mesh.clear();
+		EXPECT_TRUE(DM::CGALGeometry::FaceTriangulation(sys, faces[f], mesh));
+		double area = 0;
+		for (unsigned int i = 0; i < mesh.numberOfTriangles(); i++) {
+			const double * v1 = &mesh.vertices[3*mesh.triangles[3*i]];
+			const double * v2 = &mesh.vertices[3*mesh.triangles[3*i+1]];
+			const double * v3 = &mesh.vertices[3*mesh.triangles[3*i+2]];
+			double a = ((v2[0]-v1[0])*(v3[1]-v1[1]) - (v3[0]-v1[0])*(v2[1]-v1[1])) / 2.;
+			//Fan and cdt triangles have the same orientation
+			EXPECT_GT(a, 0);
+			area += a;
+		}
+		EXPECT_DOUBLE_EQ(area, TBVectorData::CalculateArea(sys, faces[f]));
+	}
+
+	delete sys;
+}
+
+TEST_F(UnitTestsDMExtensions,planeProjectionHorizontal){
+	ostream *out = &cout;
+	DM::Log::init(new DM::OStreamLogSink(*out), DM::Standard);
+	DM::System * sys = new DM::System();
+
+	//L shaped roof at z = 7.3
+	std::vector<DM::Node * > nodes;
+	nodes.push_back(sys->addNode(DM::Node(0.1,0.1,7.3)));
+	nodes.push_back(sys->addNode(DM::Node(2.3,0.1,7.3)));
+	nodes.push_back(sys->addNode(DM::Node(2.3,1.7,7.3)));
+	nodes.push_back(sys->addNode(DM::Node(1.1,1.7,7.3)));
+	nodes.push_back(sys->addNode(DM::Node(1.1,2.9,7.3)));
+	nodes.push_back(sys->addNode(DM::Node(0.1,2.9,7.3)));
+
+	DM::PlaneProjection projection(nodes, true);
+	EXPECT_TRUE(projection.isAxisAligned());
+	double v[3] = {0.3, 0.7, 7.3};
+	double v_t[3];
+	double v_b[3];
+	projection.toPlane(v, v_t);
+	projection.fromPlane(v_t, v_b);
+	for (int i = 0; i < 3; i++)
+		EXPECT_EQ(v[i], v_b[i]);
+
+	nodes.push_back(nodes[0]);
+	DM::Face * ccw = sys->addFace(nodes);
+	std::reverse(nodes.begin(), nodes.end());
+	DM::Face * cw = sys->addFace(nodes);
+
+	DM::Face * faces[2] = {ccw, cw};
+	for (int f = 0; f < 2; f++) {
+		DM::IndexedMesh mesh;
+		EXPECT_TRUE(DM::CGALGeometry::FaceTriangulation(sys, faces[f], mesh));
+		EXPECT_EQ(mesh.numberOfVertices(), 6);
+		EXPECT_EQ(mesh.numberOfTriangles(), 4);
+
+		//Vertices are the input nodes without rounding
+		for (unsigned int i = 0; i < mesh.numberOfVertices(); i++) {
+			EXPECT_EQ(mesh.vertices[3*i+2], 7.3);
+			bool found = false;
+			for (unsigned int j = 0; j < nodes.size(); j++)
+				found = found || (nodes[j]->getX() == mesh.vertices[3*i] && nodes[j]->getY() == mesh.vertices[3*i+1]);
+			EXPECT_TRUE(found);
+		}
+
+		//Triangles follow the orientation of the face
+		for (unsigned int i = 0; i < mesh.numberOfTriangles(); i++) {
+			const double * v1 = &mesh.vertices[3*mesh.triangles[3*i]];
+			const double * v2 = &mesh.vertices[3*mesh.triangles[3*i+1]];
+			const double * v3 = &mesh.vertices[3*mesh.triangles[3*i+2]];
+			double a = (v2[0]-v1[0])*(v3[1]-v1[1]) - (v3[0]-v1[0])*(v2[1]-v1[1]);
+			if (f == 0)
+				EXPECT_GT(a, 0);
+			else
+				EXPECT_LT(a, 0);
+		}
+	}
+
+	//Walls are not horizontal
+	std::vector<DM::Node * > wall;
+	wall.push_back(sys->addNode(DM::Node(0,0,0)));
+	wall.push_back(sys->addNode(DM::Node(1,1,0)));
+	wall.push_back(sys->addNode(DM::Node(1,1,3)));
+	EXPECT_FALSE(DM::PlaneProjection(wall, true).isAxisAligned());
+
+	delete sys;
+}
+
+TEST_F(UnitTestsDMExtensions,triangulationCache){
+	ostream *out = &cout;
+	DM::Log::init(new DM::OStreamLogSink(*out), DM::Standard);
+	DM::System * sys = new DM::System();
+
+	DM::TriangulationCache::clear();
+	DM::TriangulationCache::setMemoryBudget(1024 * 1024);
+
+	std::vector<DM::Node * > nodes;
+	nodes.push_back(sys->addNode(DM::Node(0,0,0)));
+	nodes.push_back(sys->addNode(DM::Node(2,0,0)));
+	nodes.push_back(sys->addNode(DM::Node(2,1,0)));
+	nodes.push_back(sys->addNode(DM::Node(1,1,0)));
+	nodes.push_back(sys->addNode(DM::Node(1,2,0)));
+	nodes.push_back(sys->addNode(DM::Node(0,2,0)));
+	nodes.push_back(nodes[0]);
+	DM::Face * f = sys->addFace(nodes);
+
+	std::vector<DM::Node> first = DM::CGALGeometry::FaceTriangulation(sys, f);
+	std::vector<DM::Node> second = DM::CGALGeometry::FaceTriangulation(sys, f);
+	EXPECT_EQ(DM::TriangulationCache::getMisses(), 1);
+	EXPECT_EQ(DM::TriangulationCache::getHits(), 1);
+	ASSERT_EQ(first.size(), second.size());
+	for (unsigned int i = 0; i < first.size(); i++) {
+		EXPECT_EQ(first[i].getX(), second[i].getX());
+		EXPECT_EQ(first[i].getY(), second[i].getY());
+	}
+
+	//Regular triangulation is cached per mesh size
+	std::vector<int> ids;
+	std::vector<DM::Node> regular = DM::CGALGeometry::RegularFaceTriangulation(sys, f, ids, 0.5);
+	std::vector<int> ids_cached;
+	std::vector<DM::Node> regular_cached = DM::CGALGeometry::RegularFaceTriangulation(sys, f, ids_cached, 0.5);
+	EXPECT_EQ(DM::TriangulationCache::getHits(), 2);
+	EXPECT_EQ(regular.size(), regular_cached.size());
+	EXPECT_EQ(ids, ids_cached);
+	DM::CGALGeometry::RegularFaceTriangulation(sys, f, ids_cached, 0.25);
+	EXPECT_EQ(DM::TriangulationCache::getMisses(), 3);
+	EXPECT_GT(DM::TriangulationCache::getMemoryUsage(), 0);
+
+	//Moved node changes the key
+	nodes[2]->setX(3);
+	DM::CGALGeometry::FaceTriangulation(sys, f);
+	EXPECT_EQ(DM::TriangulationCache::getMisses(), 4);
+
+	DM::TriangulationCache::invalidate();
+	EXPECT_EQ(DM::TriangulationCache::getMemoryUsage(), 0);
+	DM::CGALGeometry::FaceTriangulation(sys, f);
+	EXPECT_EQ(DM::TriangulationCache::getMisses(), 5);
+
+	DM::TriangulationCache::setMemoryBudget(0);
+	DM::TriangulationCache::clear();
+
+	delete sys;
+}
+
+TEST_F(UnitTestsDMExtensions,triangulateViewConforming){
+	ostream *out = &cout;
+	DM::Log::init(new DM::OStreamLogSink(*out), DM::Standard);
+	DM::System * sys = new DM::System();
+
+	DM::View parcels("PARCEL", DM::FACE, DM::WRITE);
+
+	DM::Node * n1 = sys->addNode(DM::Node(0,0,0));
+	DM::Node * n2 = sys->addNode(DM::Node(1,0,0));
+	DM::Node * n3 = sys->addNode(DM::Node(1,1,0));
+	DM::Node * n4 = sys->addNode(DM::Node(0,1,0));
+	DM::Node * n5 = sys->addNode(DM::Node(2,0,0));
+	DM::Node * n6 = sys->addNode(DM::Node(2,1,0));
+	DM::Node * n7 = sys->addNode(DM::Node(1,0.5,0));
+
+	std::vector<DM::Node * > nodes;
+	nodes.push_back(n1);
+	nodes.push_back(n2);
+	nodes.push_back(n3);
+	nodes.push_back(n4);
+	nodes.push_back(n1);
+	sys->addFace(nodes, parcels);
+
+	//Second parcel has an additional node on the shared edge
+	nodes.clear();
+	nodes.push_back(n2);
+	nodes.push_back(n5);
+	nodes.push_back(n6);
+	nodes.push_back(n3);
+	nodes.push_back(n7);
+	nodes.push_back(n2);
+	sys->addFace(nodes, parcels);
+
+	DM::IndexedMesh mesh;
+	std::vector<int> triangleFace;
+	DM::CGALGeometry::TriangulateViewConforming(sys, parcels, mesh, triangleFace);
+
+	EXPECT_EQ(mesh.numberOfVertices(), 7);
+	ASSERT_EQ(triangleFace.size(), mesh.numberOfTriangles());
+
+	double areas[2] = {0, 0};
+	for (unsigned int i = 0; i < mesh.numberOfTriangles(); i++) {
+		const double * v1 = &mesh.vertices[3*mesh.triangles[3*i]];
+		const double * v2 = &mesh.vertices[3*mesh.triangles[3*i+1]];
+		const double * v3 = &mesh.vertices[3*mesh.triangles[3*i+2]];
+		ASSERT_GE(triangleFace[i], 0);
+		ASSERT_LT(triangleFace[i], 2);
+		areas[triangleFace[i]] += fabs((v2[0]-v1[0])*(v3[1]-v1[1]) - (v3[0]-v1[0])*(v2[1]-v1[1])) / 2.;
+
+		//The shared edge is split by the node of the second parcel
+		int onSeam = 0;
+		for (int j = 0; j < 3; j++) {
+			const double * v = &mesh.vertices[3*mesh.triangles[3*i+j]];
+			if (v[0] == 1 && (v[1] == 0 || v[1] == 1))
+				onSeam++;
+		}
+		EXPECT_LT(onSeam, 2);
+	}
+	EXPECT_DOUBLE_EQ(areas[0], 1);
+	EXPECT_DOUBLE_EQ(areas[1], 1);
+
+	delete sys;
+}
+
+TEST_F(UnitTestsDMExtensions,triangulateViewConformingDegenerate){
+	ostream *out = &cout;
+	DM::Log::init(new DM::OStreamLogSink(*out), DM::Standard);
+	DM::System * sys = new DM::System();
+
+	DM::View parcels("PARCEL", DM::FACE, DM::WRITE);
+
+	DM::IndexedMesh mesh;
+	std::vector<int> triangleFace;
+	mesh.addVertex(0, 0, 0);
+	triangleFace.push_back(0);
+
+	//Empty view
+	DM::CGALGeometry::TriangulateViewConforming(sys, parcels, mesh, triangleFace);
+	EXPECT_EQ(mesh.numberOfVertices(), 0);
+	EXPECT_EQ(mesh.numberOfTriangles(), 0);
+	EXPECT_TRUE(triangleFace.empty());
+
+	//Collinear face
+	std::vector<DM::Node * > nodes;
+	nodes.push_back(sys->addNode(DM::Node(0,0,0)));
+	nodes.push_back(sys->addNode(DM::Node(1,0,0)));
+	nodes.push_back(sys->addNode(DM::Node(2,0,0)));
+	nodes.push_back(nodes[0]);
+	sys->addFace(nodes, parcels);
+
+	DM::CGALGeometry::TriangulateViewConforming(sys, parcels, mesh, triangleFace);
+	EXPECT_EQ(mesh.numberOfVertices(), 0);
+	EXPECT_EQ(mesh.numberOfTriangles(), 0);
+	EXPECT_TRUE(triangleFace.empty());
+
+	delete sys;
+}
+
+TEST_F(UnitTestsDMExtensions,regularTriangulationIndexed){
+	ostream *out = &cout;
+	DM::Log::init(new DM::OStreamLogSink(*out), DM::Standard);
+	DM::System * sys = new DM::System();
+
+	DM::View parcels("PARCEL", DM::FACE, DM::WRITE);
+	addRectangleWithHole(sys, parcels);
+	DM::Face * f = static_cast<DM::Face*>(sys->getAllComponentsInView(parcels)[0]);
+
+	DM::IndexedMesh mesh;
+	CGALRegularTriangulation::Triangulation(sys, f, 0.1, mesh);
+	ASSERT_GT(mesh.numberOfTriangles(), 8);
+
+	//Every vertex is used and stored once
+	std::vector<int> used(mesh.numberOfVertices(), 0);
+	double area = 0;
+	for (unsigned int i = 0; i < mesh.numberOfTriangles(); i++) {
+		for (int j = 0; j < 3; j++) {
+			ASSERT_LT(mesh.triangles[3*i+j], mesh.numberOfVertices());
+			used[mesh.triangles[3*i+j]] = 1;
+		}
+		const double * v1 = &mesh.vertices[3*mesh.triangles[3*i]];
+		const double * v2 = &mesh.vertices[3*mesh.triangles[3*i+1]];
+		const double * v3 = &mesh.vertices[3*mesh.triangles[3*i+2]];
+		area += fabs((v2[0]-v1[0])*(v3[1]-v1[1]) - (v3[0]-v1[0])*(v2[1]-v1[1])) / 2.;
+	}
+	for (unsigned int i = 0; i < used.size(); i++)
+		EXPECT_EQ(used[i], 1);
+	EXPECT_NEAR(area, 0.75, 0.000001);
+
+	//Node and id output is the same mesh
+	std::vector<int> ids;
+	std::vector<DM::Node> nodes = DM::CGALGeometry::RegularFaceTriangulation(sys, f, ids, 0.1);
+	EXPECT_EQ(nodes.size(), mesh.numberOfVertices());
+	EXPECT_EQ(ids.size(), mesh.triangles.size());
+
+	delete sys;
+}
+
+TEST_F(UnitTestsDMExtensions,gradedRegularTriangulation){
+	ostream *out = &cout;
+	DM::Log::init(new DM::OStreamLogSink(*out), DM::Standard);
+	DM::System * sys = new DM::System();
+
+	DM::View streets("STREET", DM::EDGE, DM::WRITE);
+
+	std::vector<DM::Node * > nodes;
+	nodes.push_back(sys->addNode(DM::Node(0,0,0)));
+	nodes.push_back(sys->addNode(DM::Node(10,0,0)));
+	nodes.push_back(sys->addNode(DM::Node(10,10,0)));
+	nodes.push_back(sys->addNode(DM::Node(0,10,0)));
+	nodes.push_back(nodes[0]);
+	DM::Face * f = sys->addFace(nodes);
+
+	//Street along the lower border
+	sys->addEdge(nodes[0], nodes[1], streets);
+
+	DM::EdgeDistanceSizeField field(sys, streets, 0.5, 3, 0.5);
+	EXPECT_DOUBLE_EQ(field.distance(5, 2), 2);
+	EXPECT_DOUBLE_EQ(field.size(5, 2), 1.5);
+	EXPECT_DOUBLE_EQ(field.size(5, 9), 3);
+
+	DM::IndexedMesh graded;
+	DM::MeshStatistics stats = DM::CGALGeometry::RegularFaceTriangulation(sys, f, field, graded);
+	EXPECT_NEAR(stats.area, 100, 0.000001);
+	EXPECT_EQ(stats.triangles, graded.numberOfTriangles());
+
+	DM::IndexedMesh uniform;
+	DM::ConstantSizeField constant(0.5);
+	DM::CGALGeometry::RegularFaceTriangulation(sys, f, constant, uniform);
+	EXPECT_LT(graded.numberOfTriangles(), uniform.numberOfTriangles() / 2);
+	EXPECT_LT(stats.triangles, stats.uniformTriangles);
+
+	//Fine elements along the street
+	for (unsigned int i = 0; i < graded.numberOfTriangles(); i++) {
+		const double * v1 = &graded.vertices[3*graded.triangles[3*i]];
+		const double * v2 = &graded.vertices[3*graded.triangles[3*i+1]];
+		if (v1[1] == 0 && v2[1] == 0)
+			EXPECT_LE(fabs(v2[0] - v1[0]), 0.5 + 0.000001);
+	}
+
+	delete sys;
+}
+
+TEST_F(UnitTestsDMExtensions,tiledRegularTriangulation){
+	ostream *out = &cout;
+	DM::Log::init(new DM::OStreamLogSink(*out), DM::Standard);
+	DM::System * sys = new DM::System();
+
+	std::vector<DM::Node * > nodes;
+	nodes.push_back(sys->addNode(DM::Node(0,0,0)));
+	nodes.push_back(sys->addNode(DM::Node(10,0,0)));
+	nodes.push_back(sys->addNode(DM::Node(10,10,0)));
+	nodes.push_back(sys->addNode(DM::Node(0,10,0)));
+	nodes.push_back(nodes[0]);
+
+	std::vector<DM::Node * > nodes_h;
+	nodes_h.push_back(sys->addNode(DM::Node(4,4,0)));
+	nodes_h.push_back(sys->addNode(DM::Node(6,4,0)));
+	nodes_h.push_back(sys->addNode(DM::Node(6,6,0)));
+	nodes_h.push_back(sys->addNode(DM::Node(4,6,0)));
+	nodes_h.push_back(nodes_h[0]);
+
+	DM::Face * f = sys->addFace(nodes);
+	f->addHole(nodes_h);
+
+	DM::IndexedMesh mesh;
+	DM::CGALGeometry::TiledRegularFaceTriangulation(sys, f, 0.5, 3, mesh);
+	ASSERT_GT(mesh.numberOfTriangles(), 0);
+
+	double area = 0;
+	std::map<std::pair<unsigned int, unsigned int>, int> edges;
+	for (unsigned int i = 0; i < mesh.numberOfTriangles(); i++) {
+		const double * v1 = &mesh.vertices[3*mesh.triangles[3*i]];
+		const double * v2 = &mesh.vertices[3*mesh.triangles[3*i+1]];
+		const double * v3 = &mesh.vertices[3*mesh.triangles[3*i+2]];
+		area += fabs((v2[0]-v1[0])*(v3[1]-v1[1]) - (v3[0]-v1[0])*(v2[1]-v1[1])) / 2.;
+		for (int j = 0; j < 3; j++) {
+			//Also on the tile lines no edge is longer than the mesh size
+			const double * e1 = &mesh.vertices[3*mesh.triangles[3*i+j]];
+			const double * e2 = &mesh.vertices[3*mesh.triangles[3*i+(j+1)%3]];
+			EXPECT_LE(sqrt((e2[0]-e1[0])*(e2[0]-e1[0]) + (e2[1]-e1[1])*(e2[1]-e1[1])), 0.5 + 0.000001);
+			unsigned int a = mesh.triangles[3*i+j];
+			unsigned int b = mesh.triangles[3*i+(j+1)%3];
+			edges[std::make_pair(std::min(a, b), std::max(a, b))]++;
+		}
+	}
+	EXPECT_NEAR(area, 96, 0.000001);
+
+	//Conforming: edges used once are on the border of the face or the hole
+	for (std::map<std::pair<unsigned int, unsigned int>, int>::const_iterator it = edges.begin(); it != edges.end(); ++it) {
+		EXPECT_LE(it->second, 2);
+		if (it->second == 2)
+			continue;
+		double x = (mesh.vertices[3*it->first.first] + mesh.vertices[3*it->first.second]) / 2.;
+		double y = (mesh.vertices[3*it->first.first+1] + mesh.vertices[3*it->first.second+1]) / 2.;
+		bool outerBorder = x == 0 || x == 10 || y == 0 || y == 10;
+		bool holeBorder = ((x == 4 || x == 6) && y >= 4 && y <= 6) || ((y == 4 || y == 6) && x >= 4 && x <= 6);
+		EXPECT_TRUE(outerBorder || holeBorder);
+	}
+
+	delete sys;
+}
+
+TEST_F(UnitTestsDMExtensions,regularTriangulationTopology){
+	ostream *out = &cout;
+	DM::Log::init(new DM::OStreamLogSink(*out), DM::Standard);
+	DM::System * sys = new DM::System();
+
+	std::vector<DM::Node * > nodes;
+	nodes.push_back(sys->addNode(DM::Node(0,0,0)));
+	nodes.push_back(sys->addNode(DM::Node(10,0,0)));
+	nodes.push_back(sys->addNode(DM::Node(10,10,0)));
+	nodes.push_back(sys->addNode(DM::Node(0,10,0)));
+	nodes.push_back(nodes[0]);
+
+	std::vector<DM::Node * > nodes_h;
+	nodes_h.push_back(sys->addNode(DM::Node(4,4,0)));
+	nodes_h.push_back(sys->addNode(DM::Node(6,4,0)));
+	nodes_h.push_back(sys->addNode(DM::Node(6,6,0)));
+	nodes_h.push_back(sys->addNode(DM::Node(4,6,0)));
+	nodes_h.push_back(nodes_h[0]);
+
+	DM::Face * f = sys->addFace(nodes);
+	f->addHole(nodes_h);
+
+	DM::IndexedMesh mesh;
+	DM::MeshTopology topology;
+	DM::CGALGeometry::RegularFaceTriangulation(sys, f, 1, mesh, topology);
+
+	unsigned int n = mesh.numberOfTriangles();
+	ASSERT_GT(n, 0);
+	ASSERT_EQ(topology.numberOfTriangles(), n);
+	ASSERT_EQ(topology.neighbours.size(), 3*n);
+
+	double area = 0;
+	for (unsigned int i = 0; i < n; i++) {
+		area += topology.areas[i];
+		for (int j = 0; j < 3; j++) {
+			//Neighbours are symmetric and share the edge
+			int nb = topology.neighbours[3*i+j];
+			unsigned int e = topology.triangleEdges[3*i+j];
+			if (nb == -1) {
+				EXPECT_TRUE(topology.isBoundary(e));
+				continue;
+			}
+			EXPECT_FALSE(topology.isBoundary(e));
+			bool found = false;
+			for (int k = 0; k < 3; k++)
+				found = found || (topology.neighbours[3*nb+k] == (int) i && topology.triangleEdges[3*nb+k] == e);
+			EXPECT_TRUE(found);
+		}
+	}
+	EXPECT_NEAR(area, 96, 0.000001);
+
+	//Every edge connects the vertices of its triangles, 3 * triangles = 2 * inner + boundary edges
+	unsigned int boundaryEdges = 0;
+	for (unsigned int e = 0; e < topology.numberOfEdges(); e++) {
+		if (topology.isBoundary(e))
+			boundaryEdges++;
+		unsigned int t = topology.edgeTriangles[2*e];
+		int matches = 0;
+		for (int k = 0; k < 3; k++) {
+			if (mesh.triangles[3*t+k] == topology.edges[2*e] || mesh.triangles[3*t+k] == topology.edges[2*e+1])
+				matches++;
+		}
+		EXPECT_EQ(matches, 2);
+	}
+	EXPECT_EQ(3*n, 2*(topology.numberOfEdges() - boundaryEdges) + boundaryEdges);
+
+	delete sys;
+}
+
+TEST_F(UnitTestsDMExtensions,triangulateRasterData){
+	ostream *out = &cout;
+	DM::Log::init(new DM::OStreamLogSink(*out), DM::Standard);
+	DM::System * sys = new DM::System();
+
+	DM::RasterGeometry raster;
+	raster.width = 3;
+	raster.height = 3;
+	raster.xOffset = 0;
+	raster.yOffset = 0;
+	raster.cellSizeX = 1;
+	raster.cellSizeY = 1;
+	raster.noValue = -9999;
+
+	//The last cell has no data, the upper right block is covered by one triangle
+	std::vector<double> values;
+	for (int i = 0; i < 8; i++)
+		values.push_back(i);
+	values.push_back(-9999);
+
+	DM::IndexedMesh mesh;
+	TriangulateRasterData::Triangulation(raster, values, mesh);
+	ASSERT_EQ(mesh.numberOfVertices(), 8);
+	ASSERT_EQ(mesh.numberOfTriangles(), 7);
+
+	double area = 0;
+	for (unsigned int i = 0; i < mesh.numberOfTriangles(); i++) {
+		const double * v1 = &mesh.vertices[3*mesh.triangles[3*i]];
+		const double * v2 = &mesh.vertices[3*mesh.triangles[3*i+1]];
+		const double * v3 = &mesh.vertices[3*mesh.triangles[3*i+2]];
+		double a = ((v2[0]-v1[0])*(v3[1]-v1[1]) - (v3[0]-v1[0])*(v2[1]-v1[1])) / 2.;
+		EXPECT_GT(a, 0);
+		area += a;
+		//The height is the value of the cell
+		EXPECT_DOUBLE_EQ(v1[2], v1[1] * 3 + v1[0]);
+	}
+	EXPECT_DOUBLE_EQ(area, 3.5);
+
+	delete sys;
+}
+
+TEST_F(UnitTestsDMExtensions,adaptiveTriangulateRasterData){
+	ostream *out = &cout;
+	DM::Log::init(new DM::OStreamLogSink(*out), DM::Standard);
+	DM::System * sys = new DM::System();
+
+	DM::RasterGeometry raster;
+	raster.width = 9;
+	raster.height = 9;
+	raster.xOffset = 0;
+	raster.yOffset = 0;
+	raster.cellSizeX = 1;
+	raster.cellSizeY = 1;
+	raster.noValue = -9999;
+
+	//A plane is represented by the 4 triangles of the root block
+	std::vector<double> values;
+	for (int y = 0; y < 9; y++) {
+		for (int x = 0; x < 9; x++)
+			values.push_back(2 * x + y);
+	}
+	DM::IndexedMesh plane;
+	TriangulateRasterData::AdaptiveTriangulation(raster, values, 0.01, plane);
+	EXPECT_EQ(plane.numberOfTriangles(), 4);
+	EXPECT_EQ(plane.numberOfVertices(), 5);
+
+	//A peak is refined, the mesh has no T-junctions and covers the raster
+	values[2 * 9 + 2] += 10;
+	DM::IndexedMesh mesh;
+	TriangulateRasterData::AdaptiveTriangulation(raster, values, 0.01, mesh);
+	EXPECT_GT(mesh.numberOfTriangles(), 4);
+	EXPECT_LT(mesh.numberOfTriangles(), 128);
+
+	double area = 0;
+	std::map<std::pair<unsigned int, unsigned int>, int> edges;
+	for (unsigned int i = 0; i < mesh.numberOfTriangles(); i++) {
+		const double * v1 = &mesh.vertices[3*mesh.triangles[3*i]];
+		const double * v2 = &mesh.vertices[3*mesh.triangles[3*i+1]];
+		const double * v3 = &mesh.vertices[3*mesh.triangles[3*i+2]];
+		double a = ((v2[0]-v1[0])*(v3[1]-v1[1]) - (v3[0]-v1[0])*(v2[1]-v1[1])) / 2.;
+		EXPECT_GT(a, 0);
+		area += a;
+		for (int j = 0; j < 3; j++) {
+			unsigned int e1 = mesh.triangles[3*i+j];
+			unsigned int e2 = mesh.triangles[3*i+(j+1)%3];
+			edges[std::make_pair(std::min(e1, e2), std::max(e1, e2))]++;
+		}
+	}
+	EXPECT_DOUBLE_EQ(area, 64);
+
+	//Edges used once are on the raster border
+	for (std::map<std::pair<unsigned int, unsigned int>, int>::const_iterator it = edges.begin(); it != edges.end(); ++it) {
+		EXPECT_LE(it->second, 2);
+		if (it->second == 2)
+			continue;
+		double x = (mesh.vertices[3*it->first.first] + mesh.vertices[3*it->first.second]) / 2.;
+		double y = (mesh.vertices[3*it->first.first+1] + mesh.vertices[3*it->first.second+1]) / 2.;
+		EXPECT_TRUE(x == 0 || x == 8 || y == 0 || y == 8);
+	}
+
+	delete sys;
+}
+
+TEST_F(UnitTestsDMExtensions,straightSkeletonRoofFaces){
+	ostream *out = &cout;
+	DM::Log::init(new DM::OStreamLogSink(*out), DM::Standard);
+	DM::System * sys = new DM::System();
+
+	std::vector<DM::Node * > nodes;
+	nodes.push_back(sys->addNode(DM::Node(0,0,3)));
+	nodes.push_back(sys->addNode(DM::Node(4,0,3)));
+	nodes.push_back(sys->addNode(DM::Node(4,2,3)));
+	nodes.push_back(sys->addNode(DM::Node(0,2,3)));
+	nodes.push_back(nodes[0]);
+
+	DM::Face * f = sys->addFace(nodes);
+
+	//Hip roof, the ridge is 1 above the footprint for 45 degrees
+	DM::System rn = DM::CGALSkeletonisation::StraightSkeletonisation(sys, f, 45);
+	DM::View roof("Roof", DM::FACE, DM::READ);
+	std::vector<DM::Component *> faces = rn.getAllComponentsInView(roof);
+	ASSERT_EQ(faces.size(), 4);
+
+	double max_z = 0;
+	foreach(DM::Component * c, faces) {
+		foreach(DM::Node * n, ((DM::Face *) c)->getNodePointers()) {
+			EXPECT_GE(n->getZ(), 3 - 0.000001);
+			max_z = std::max(max_z, n->getZ());
+		}
+	}
+	EXPECT_NEAR(max_z, 4, 0.000001);
+
+	delete sys;
+}
+
+TEST_F(UnitTestsDMExtensions,createRoofs){
+	ostream *out = &cout;
+	DM::Log::init(new DM::OStreamLogSink(*out), DM::Standard);
+	DM::System * sys = new DM::System();
+	DM::View footprints("FOOTPRINT", DM::FACE, DM::WRITE);
+	DM::View geometry("Geometry", DM::FACE, DM::WRITE);
+
+	std::vector<LittleGeometryHelpers::RoofType> types;
+	std::vector<double> heights;
+	for (int i = 0; i < 2; i++) {
+		std::vector<DM::Node * > nodes;
+		nodes.push_back(sys->addNode(DM::Node(10*i,0,0)));
+		nodes.push_back(sys->addNode(DM::Node(10*i+4,0,0)));
+		nodes.push_back(sys->addNode(DM::Node(10*i+4,2,0)));
+		nodes.push_back(sys->addNode(DM::Node(10*i,2,0)));
+		nodes.push_back(nodes[0]);
+		sys->addFace(nodes, footprints);
+		types.push_back(i == 0 ? LittleGeometryHelpers::GABLE_ROOF : LittleGeometryHelpers::HIP_ROOF);
+		heights.push_back(3);
+	}
+
+	LittleGeometryHelpers::CreateRoofs(sys, footprints, geometry, types, heights, 45);
+
+	//Both roofs have 4 faces, the ridge is 1 above the eaves
+	std::vector<DM::Component *> faces = sys->getAllComponentsInView(geometry);
+	ASSERT_EQ(faces.size(), 8);
+	int walls = 0;
+	foreach(DM::Component * c, faces) {
+		if (c->getAttribute("type")->getString() == "roof_wall")
+			walls++;
+		double max_z = 0;
+		foreach(DM::Node * n, ((DM::Face *) c)->getNodePointers())
+			max_z = std::max(max_z, n->getZ());
+		EXPECT_NEAR(max_z, 4, 0.000001);
+	}
+	EXPECT_EQ(walls, 2);
+
+	delete sys;
+}
+
+TEST_F(UnitTestsDMExtensions,geometryLogLevel){
+	ostream *out = &cout;
+	DM::Log::init(new DM::OStreamLogSink(*out), DM::Standard);
+	DM::System * sys = new DM::System();
+
+	DM::LogLevel level = DM::GeometryLog::getLevel();
+
+	//Debug messages are filtered by default
+	int counter = 0;
+	EXPECT_EQ(level, DM::Standard);
+	DM_GEOMETRY_LOG(DM::Debug) << countEvaluation(counter);
+	EXPECT_EQ(counter, 0);
+	DM_GEOMETRY_LOG(DM::Standard) << countEvaluation(counter);
+	EXPECT_EQ(counter, 1);
+
+	//Arguments of filtered messages are not evaluated
+	counter = 0;
+	DM::GeometryLog::setLevel(DM::Warning);
+	DM_GEOMETRY_LOG(DM::Debug) << countEvaluation(counter);
+	DM_GEOMETRY_LOG(DM::Standard) << countEvaluation(counter);
+	EXPECT_EQ(counter, 0);
+	DM_GEOMETRY_LOG(DM::Warning) << countEvaluation(counter);
+	EXPECT_EQ(counter, 1);
+
+	DM::GeometryLog::setLevel(level);
+	delete sys;
+}
+
+TEST_F(UnitTestsDMExtensions,spatialSearchNearestNodes){
+	ostream *out = &cout;
+	DM::Log::init(new DM::OStreamLogSink(*out), DM::Standard);
+	DM::System * sys = new DM::System();
+
+	std::vector<DM::Node *> nodes;
+	for (int x = 0; x < 10; x++) {
+		for (int y = 0; y < 10; y++)
+			nodes.push_back(sys->addNode(DM::Node(x, y, 0)));
+	}
+	//Two nodes at the same position, the tree returns one of the stored pointers
+	DM::Node * duplicate = sys->addNode(DM::Node(20, 20, 0));
+	DM::Node * duplicate2 = sys->addNode(DM::Node(20, 20, 0));
+	nodes.push_back(duplicate);
+	nodes.push_back(duplicate2);
+
+	SpatialSearchNearestNodes search(sys, nodes);
+
+	DM::Node query(3.2, 6.9, 0);
+	DM::Node * nearest = search.findNearestNode(&query);
+	ASSERT_TRUE(nearest != 0);
+	EXPECT_EQ(nearest, nodes[3 * 10 + 7]);
+
+	DM::Node far(19, 19, 0);
+	DM::Node * found = search.findNearestNode(&far);
+	EXPECT_TRUE(found == duplicate || found == duplicate2);
+	EXPECT_TRUE(search.findNearestNode(&far, 1) == 0);
+
+	delete sys;
+}
+
+TEST_F(UnitTestsDMExtensions,spatialSearchBatchQueries){
+	ostream *out = &cout;
+	DM::Log::init(new DM::OStreamLogSink(*out), DM::Standard);
+	DM::System * sys = new DM::System();
+
+	std::vector<DM::Node *> nodes;
+	for (int x = 0; x < 10; x++)
+		nodes.push_back(sys->addNode(DM::Node(x, 0, 0)));
+
+	SpatialSearchNearestNodes search(sys, nodes);
+
+	DM::Node query(3.1, 0, 0);
+	std::vector<DM::Node *> nearest = search.findNearestNodes(&query, 3);
+	ASSERT_EQ(nearest.size(), 3);
+	EXPECT_EQ(nearest[0], nodes[3]);
+	EXPECT_EQ(nearest[1], nodes[4]);
+	EXPECT_EQ(nearest[2], nodes[2]);
+
+	std::vector<DM::Node *> inRadius = search.findNodesInRadius(&query, 1.5);
+	ASSERT_EQ(inRadius.size(), 3);
+	EXPECT_EQ(inRadius[0], nodes[3]);
+
+	//Batch, the second query only has one node within the treshhold
+	std::vector<DM::Node *> queries;
+	queries.push_back(sys->addNode(DM::Node(0, 0.5, 0)));
+	queries.push_back(sys->addNode(DM::Node(20, 0, 0)));
+	std::vector<int> indices;
+	std::vector<double> distances;
+	search.findNearestNodes(queries, 2, indices, distances, 11.5);
+	ASSERT_EQ(indices.size(), 4);
+	EXPECT_EQ(indices[0], 0);
+	EXPECT_EQ(indices[1], 1);
+	EXPECT_DOUBLE_EQ(distances[0], 0.5);
+	EXPECT_EQ(indices[2], 9);
+	EXPECT_EQ(indices[3], -1);
+	EXPECT_DOUBLE_EQ(distances[2], 11);
+	EXPECT_DOUBLE_EQ(distances[3], -1);
+
+	std::vector<unsigned int> offsets;
+	search.findNodesInRadius(queries, 1.2, offsets, indices, distances);
+	ASSERT_EQ(offsets.size(), 3);
+	EXPECT_EQ(offsets[1], 2);
+	EXPECT_EQ(offsets[2], 2);
+	EXPECT_EQ(indices[0], 0);
+	EXPECT_EQ(indices[1], 1);
+
+	delete sys;
+}
+
+TEST_F(UnitTestsDMExtensions,spatialSearchEmpty){
+	ostream *out = &cout;
+	DM::Log::init(new DM::OStreamLogSink(*out), DM::Standard);
+	DM::System * sys = new DM::System();
+
+	std::vector<DM::Node *> nodes;
+	SpatialSearchNearestNodes search(sys, nodes);
+
+	DM::Node query(1, 2, 0);
+	EXPECT_TRUE(search.findNearestNode(&query) == 0);
+	EXPECT_TRUE(search.findNearestNodes(&query, 3).empty());
+	EXPECT_TRUE(search.findNodesInRadius(&query, 10).empty());
+
+	std::vector<DM::Node *> queries;
+	queries.push_back(&query);
+	queries.push_back(&query);
+	std::vector<int> indices;
+	std::vector<double> distances;
+	search.findNearestNodes(queries, 2, indices, distances);
+	ASSERT_EQ(indices.size(), 4);
+	ASSERT_EQ(distances.size(), 4);
+	for (int i = 0; i < 4; i++) {
+		EXPECT_EQ(indices[i], -1);
+		EXPECT_DOUBLE_EQ(distances[i], -1);
+	}
+
+	std::vector<unsigned int> offsets;
+	search.findNodesInRadius(queries, 10, offsets, indices, distances);
+	ASSERT_EQ(offsets.size(), 3);
+	EXPECT_EQ(offsets[1], 0);
+	EXPECT_EQ(offsets[2], 0);
+	EXPECT_TRUE(indices.empty());
+	EXPECT_TRUE(distances.empty());
+
+	delete sys;
+}
+
+TEST_F(UnitTestsDMExtensions,gradedRegularTriangulationInvalidField){
+	ostream *out = &cout;
+	DM::Log::init(new DM::OStreamLogSink(*out), DM::Standard);
+	DM::System * sys = new DM::System();
+
+	std::vector<DM::Node * > nodes;
+	nodes.push_back(sys->addNode(DM::Node(0,0,0)));
+	nodes.push_back(sys->addNode(DM::Node(10,0,0)));
+	nodes.push_back(sys->addNode(DM::Node(10,10,0)));
+	nodes.push_back(sys->addNode(DM::Node(0,10,0)));
+	nodes.push_back(nodes[0]);
+	DM::Face * f = sys->addFace(nodes);
+
+	//A field without a positive minimum size would refine forever and is rejected
+	DM::View streets("STREET", DM::EDGE, DM::WRITE);
+	sys->addEdge(nodes[0], nodes[1], streets);
+	DM::EdgeDistanceSizeField field(sys, streets, 0, 5, 0.5);
+	DM::IndexedMesh mesh;
+	DM::MeshStatistics stats = DM::CGALGeometry::RegularFaceTriangulation(sys, f, field, mesh);
+	EXPECT_EQ(stats.triangles, 0);
+	EXPECT_EQ(mesh.numberOfTriangles(), 0);
+
+	delete sys;
+}
+
+TEST_F(UnitTestsDMExtensions,triangulateRasterDataStrips){
+	ostream *out = &cout;
+	DM::Log::init(new DM::OStreamLogSink(*out), DM::Standard);
+	DM::System * sys = new DM::System();
+
+	DM::RasterGeometry raster;
+	raster.width = 4;
+	raster.height = 4;
+	raster.xOffset = 0;
+	raster.yOffset = 0;
+	raster.cellSizeX = 1;
+	raster.cellSizeY = 1;
+	raster.noValue = -9999;
+
+	//NaN is no data, the 4 blocks around cell (1, 1) get one triangle each
+	std::vector<double> values;
+	for (int i = 0; i < 16; i++)
+		values.push_back(i);
+	double zero = 0;
+	values[5] = zero / zero;
+
+	TestRowReader reader(values, 4);
+	TestStripWriter writer;
+	TriangulateRasterData::Triangulation(raster, reader, writer, 1);
+	EXPECT_EQ(reader.rows, 4);
+	EXPECT_EQ(writer.strips, 3);
+	EXPECT_GT(writer.earlierReferences, 0);
+	EXPECT_EQ(writer.mesh.numberOfVertices(), 15);
+	EXPECT_EQ(writer.mesh.numberOfTriangles(), 14);
+
+	//One strip gives the same mesh
+	DM::IndexedMesh mesh;
+	TriangulateRasterData::Triangulation(raster, values, mesh);
+	EXPECT_EQ(mesh.triangles, writer.mesh.triangles);
+	EXPECT_EQ(mesh.vertices, writer.mesh.vertices);
+
+	delete sys;
+}
+
+TEST_F(UnitTestsDMExtensions,minBoundingBoxAngleConventions){
+	ostream *out = &cout;
+	DM::Log::init(new DM::OStreamLogSink(*out), DM::Standard);
+	DM::System * sys = new DM::System();
+	DM::View footprints("FOOTPRINT", DM::FACE, DM::WRITE);
+
+	//Long side at -30 degree
+	const double pi =  3.14159265358979323846;
+	double alpha = -30. / 180. * pi;
+	double l = 4;
+	double w = 2;
+
+	std::vector<DM::Node * > nodes;
+	nodes.push_back(sys->addNode(DM::Node(0, 0, 0)));
+	nodes.push_back(sys->addNode(DM::Node(l * cos(alpha), l * sin(alpha), 0)));
+	nodes.push_back(sys->addNode(DM::Node(l * cos(alpha) - w * sin(alpha), l * sin(alpha) + w * cos(alpha), 0)));
+	nodes.push_back(sys->addNode(DM::Node(-w * sin(alpha), w * cos(alpha), 0)));
+	nodes.push_back(nodes[0]);
+	sys->addFace(nodes, footprints);
+
+	std::vector<double> angles;
+	std::vector<double> lengths;
+	std::vector<double> widths;
+	std::vector<double> corners;
+	DM::CGALGeometry::CalculateMinBoundingBoxes(sys, footprints, angles, lengths, widths, corners);
+	ASSERT_EQ(angles.size(), 1);
+	EXPECT_NEAR(angles[0], 150, 0.0001);
+
+	//The single API reports the same box with an unsigned angle, the sign of the direction is lost
+	std::vector<DM::Node> bb;
+	std::vector<double> size;
+	double single = DM::CGALGeometry::CalculateMinBoundingBox(nodes, bb, size);
+	EXPECT_NEAR(size[0], lengths[0], 0.0001);
+	EXPECT_NEAR(size[1], widths[0], 0.0001);
+	double single_mod = fmod(single, 180.);
+	EXPECT_TRUE(fabs(single_mod - 30) < 0.0001 || fabs(single_mod - 150) < 0.0001);
+	EXPECT_NEAR(fabs(cos(single / 180. * pi)), fabs(cos(angles[0] / 180. * pi)), 0.0001);
+
+	delete sys;
+}
+
 }